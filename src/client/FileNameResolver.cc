@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include <string>
+#include <istream>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "src/common/errors.h"
+#include "src/common/LTFSDMException.h"
+#include "src/common/Message.h"
+#include "src/common/Trace.h"
+#include "src/common/Const.h"
+
+#include "FileNameResolver.h"
+
+FileNameResolver::FileNameResolver(std::istream *input_) :
+        input(input_), eof(false), abort(false), numRunning(
+                Const::RESOLVER_THREADS), pos(0)
+
+{
+    for (int i = 0; i < Const::RESOLVER_THREADS; i++)
+        resolvers.push_back(std::thread(&FileNameResolver::run, this));
+}
+
+FileNameResolver::~FileNameResolver()
+
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        abort = true;
+        cond.notify_all();
+    }
+
+    for (std::thread& resolver : resolvers)
+        resolver.join();
+}
+
+void FileNameResolver::run()
+
+{
+    std::shared_ptr<batch_t> batch;
+    std::string line;
+    char *file_name;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cond.wait(lock,
+                    [this] {return abort || eof || (int) batches.size() < Const::RESOLVER_MAX_BATCHES;});
+
+            if (abort || eof) {
+                numRunning--;
+                cond.notify_all();
+                return;
+            }
+
+            batch = std::make_shared<batch_t>();
+            batch->completed = false;
+            while ((int) batch->lines.size() < Const::RESOLVER_BATCH_SIZE
+                    && std::getline(*input, line))
+                batch->lines.push_back(line);
+            if ((int) batch->lines.size() < Const::RESOLVER_BATCH_SIZE)
+                eof = true;
+            if (batch->lines.size() == 0)
+                continue;
+            batches.push_back(batch);
+        }
+
+        batch->fileNames.resize(batch->lines.size());
+        for (unsigned long i = 0; i < batch->lines.size(); i++) {
+            if ((file_name = canonicalize_file_name(batch->lines[i].c_str()))
+                    != NULL) {
+                batch->fileNames[i] = file_name;
+                free(file_name);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        batch->completed = true;
+        cond.notify_all();
+    }
+}
+
+/**
+ * Provides the next file name in the order of the input.
+ *
+ * @param line the line as read from the input
+ * @param fileName the canonicalized file name, an empty string if
+ *        the name cannot be resolved (e.g. the file does not exist)
+ * @return false if all lines of the input have been provided
+ */
+bool FileNameResolver::next(std::string *line, std::string *fileName)
+
+{
+    std::unique_lock<std::mutex> lock(mtx);
+
+    if (batches.size() > 0 && pos == batches.front()->lines.size()) {
+        batches.pop_front();
+        pos = 0;
+        cond.notify_all();
+    }
+
+    cond.wait(lock,
+            [this] {return (batches.size() > 0 && batches.front()->completed) || (batches.size() == 0 && numRunning == 0);});
+
+    if (batches.size() == 0)
+        return false;
+
+    *line = batches.front()->lines[pos];
+    *fileName = batches.front()->fileNames[pos];
+    pos++;
+
+    return true;
+}
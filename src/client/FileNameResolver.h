@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+/** @page file_name_resolver File Name Resolver
+
+    The migrate and recall commands send the canonicalized names of the
+    files to the backend (see LTFSDMCommand::sendObjects). Resolving the
+    names by canonicalize_file_name requires path lookups and stat calls
+    that take most of the time for long file lists. The FileNameResolver
+    therefore resolves the file names by Const::RESOLVER_THREADS threads
+    in parallel:
+
+    - A thread reads the next Const::RESOLVER_BATCH_SIZE lines of the
+      input and appends them as a batch to the end of a queue. Reading is
+      serialized, so the order of the batches is the order of the input.
+    - Thereafter the thread resolves the names of that batch without
+      holding a lock and marks the batch as completed.
+    - FileNameResolver::next provides the names of the first batch of
+      the queue after it has been completed. Therefore the results are
+      provided in the order of the input.
+    - At most Const::RESOLVER_MAX_BATCHES batches are queued such that
+      the memory consumption is bounded.
+
+ */
+
+class FileNameResolver
+{
+private:
+    struct batch_t
+    {
+        std::vector<std::string> lines;
+        std::vector<std::string> fileNames;
+        bool completed;
+    };
+    std::istream *input;
+    std::deque<std::shared_ptr<batch_t>> batches;
+    std::vector<std::thread> resolvers;
+    std::mutex mtx;
+    std::condition_variable cond;
+    bool eof;
+    bool abort;
+    int numRunning;
+    unsigned long pos;
+
+    void run();
+public:
+    FileNameResolver(std::istream *input_);
+    ~FileNameResolver();
+    bool next(std::string *line, std::string *fileName);
+};
@@ -48,7 +48,11 @@
 #include "PoolAddCommand.h"
 #include "PoolRemoveCommand.h"
 #include "InfoPoolsCommand.h"
+#include "InfoThreadsCommand.h"
+#include "InfoCatalogCommand.h"
 #include "RetrieveCommand.h"
+#include "RebuildCommand.h"
+#include "ReconcileCommand.h"
 #include "HelpCommand.h"
 
 /** @page ltfsdm_help ltfsdm help
@@ -72,6 +76,8 @@
                ltfsdm recall            - recall file system objects back from tape to local disk
                ltfsdm retrieve          - synchronizes the inventory with the information
                                           provided by Spectrum Archive LE
+               ltfsdm rebuild           - rebuilds the catalog of a cartridge from its LTFS index
+               ltfsdm reconcile         - finds orphaned tape data and dangling references
                ltfsdm version           - provides the version number of LTFS Data Management
     info sub commands:
                ltfsdm info requests     - retrieve information about all or a specific LTFS Data Management requests
@@ -81,6 +87,8 @@
                ltfsdm info drives       - lists the drives known to LTFS Data Management
                ltfsdm info tapes        - lists the cartridges known to LTFS Data Management
                ltfsdm info pools        - lists all defined tape storage pools and their sizes
+               ltfsdm info threads      - provides statistics about the thread pools of the server
+               ltfsdm info catalog      - lists the files that have been migrated to a cartridge
     pool sub commands:
                ltfsdm pool create       - create a tape storage pool
                ltfsdm pool delete       - delete a tape storage pool
@@ -127,6 +135,10 @@ void HelpCommand::doCommand(int argc, char **argv)
         ltfsdmCommand = new StatusCommand();
     } else if (RetrieveCommand().compare(command)) {
         ltfsdmCommand = new RetrieveCommand();
+    } else if (RebuildCommand().compare(command)) {
+        ltfsdmCommand = new RebuildCommand();
+    } else if (ReconcileCommand().compare(command)) {
+        ltfsdmCommand = new ReconcileCommand();
     } else if (HelpCommand().compare(command)) {
         ltfsdmCommand = new HelpCommand();
     } else if (InfoCommand().compare(command)) {
@@ -149,6 +161,10 @@ void HelpCommand::doCommand(int argc, char **argv)
                 ltfsdmCommand = new InfoTapesCommand();
             } else if (InfoPoolsCommand().compare(command)) {
                 ltfsdmCommand = new InfoPoolsCommand();
+            } else if (InfoThreadsCommand().compare(command)) {
+                ltfsdmCommand = new InfoThreadsCommand();
+            } else if (InfoCatalogCommand().compare(command)) {
+                ltfsdmCommand = new InfoCatalogCommand();
             } else {
                 ltfsdmCommand = new InfoCommand();
             }
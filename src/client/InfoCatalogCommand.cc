@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <sys/resource.h>
+#include <blkid/blkid.h>
+
+#include <unistd.h>
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <memory>
+#include <sstream>
+#include <exception>
+
+#include "src/common/errors.h"
+#include "src/common/LTFSDMException.h"
+#include "src/common/Message.h"
+#include "src/common/Trace.h"
+#include "src/common/FileSystems.h"
+#include "src/common/Configuration.h"
+
+#include "src/communication/ltfsdm.pb.h"
+#include "src/communication/LTFSDmComm.h"
+
+#include "src/connector/Connector.h"
+
+#include "LTFSDMCommand.h"
+#include "InfoCatalogCommand.h"
+
+/** @page ltfsdm_info_catalog ltfsdm info catalog
+    The ltfsdm info catalog command lists the files that have been migrated
+    to a cartridge as recorded in the catalog of the backend. The files
+    are listed in the order they are stored on tape. Since the catalog
+    is maintained by the backend itself this does not require the
+    cartridge to be mounted. See @ref catalog for more information.
+
+    <tt>@LTFSDMC0117I</tt>
+
+    parameters | description
+    ---|---
+    -t \<tape id\> | the cartridge for which the files should be listed
+
+    Example:
+
+    @verbatim
+    [root@visp ~]# ltfsdm info catalog -t DV1462L6
+    start block          state                size                 file name
+    3                    migrated             1073741824           /mnt/lxfs/test1/file.0
+    8198                 migrated             1073741824           /mnt/lxfs/test1/file.1
+    16393                premigrated          1073741824           /mnt/lxfs/test1/file.2
+    @endverbatim
+
+    The corresponding class is @ref InfoCatalogCommand.
+ */
+
+void InfoCatalogCommand::printUsage()
+{
+    INFO(LTFSDMC0117I);
+}
+
+void InfoCatalogCommand::doCommand(int argc, char **argv)
+{
+    int error;
+    std::string fileName;
+
+    processOptions(argc, argv);
+
+    TRACE(Trace::normal, *argv, argc, optind);
+
+    if (argc != optind || tapeList.size() != 1) {
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    try {
+        connect();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0026E);
+        return;
+    }
+
+    LTFSDmProtocol::LTFSDmInfoCatalogRequest *infocatalog =
+            commCommand.mutable_infocatalogrequest();
+
+    infocatalog->set_key(key);
+    infocatalog->set_tapeid(tapeList.front());
+
+    try {
+        commCommand.send();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0027E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    INFO(LTFSDMC0118I);
+
+    do {
+        try {
+            commCommand.recv();
+        } catch (const std::exception& e) {
+            MSG(LTFSDMC0028E);
+            THROW(Error::GENERAL_ERROR);
+        }
+
+        const LTFSDmProtocol::LTFSDmInfoCatalogResp infocatalogresp =
+                commCommand.infocatalogresp();
+        error = infocatalogresp.error();
+        fileName = infocatalogresp.filename();
+        if (fileName.compare("") != 0)
+            INFO(LTFSDMC0119I, infocatalogresp.startblock(),
+                    FsObj::migStateStr(infocatalogresp.state()),
+                    infocatalogresp.filesize(), fileName);
+    } while (!exitClient && fileName.compare("") != 0);
+
+    if (error != static_cast<int>(Error::OK)) {
+        MSG(LTFSDMC0120E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    return;
+}
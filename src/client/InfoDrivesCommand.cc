@@ -46,11 +46,18 @@
 
     @verbatim
     [root@visp ~]# ltfsdm info drives
-    id           device name   slot         status       usage
-    9068051229   /dev/IBMtape0 256          Available    free
-    1013000505   /dev/IBMtape1 259          Available    free
+    id           device name   slot         status       usage        write MB/s   read MB/s    health
+    9068051229   /dev/IBMtape0 256          Available    free         287          -            ok
+    1013000505   /dev/IBMtape1 259          Available    free         96           -            degraded
     @endverbatim
 
+    The write and read throughputs are the moving averages the drive
+    achieved for data transfers to and from tape. They are shown as - if
+    not enough data has been transferred so far. A drive is degraded if
+    its write or read throughput is well below the one of the other
+    drives or if too many of its recent transfers failed.
+    Healthy drives are preferred when tapes are mounted.
+
     The corresponding class is @ref InfoDrivesCommand.
  */
 
@@ -108,9 +115,19 @@ void InfoDrivesCommand::doCommand(int argc, char **argv)
         unsigned long slot = infodrivesresp.slot();
         std::string status = infodrivesresp.status();
         bool busy = infodrivesresp.busy();
+        unsigned long writeThroughput = infodrivesresp.writethroughput();
+        unsigned long readThroughput = infodrivesresp.readthroughput();
+        bool degraded = infodrivesresp.degraded();
         if (id.compare("") != 0)
             INFO(LTFSDMC0070I, id, devname, slot, status,
-                    busy ? ltfsdm_messages[LTFSDMC0071I] : ltfsdm_messages[LTFSDMC0072I]);
+                    busy ? ltfsdm_messages[LTFSDMC0071I] : ltfsdm_messages[LTFSDMC0072I],
+                    writeThroughput > 0 ?
+                            std::to_string(writeThroughput / (1024 * 1024)) :
+                            std::string("-"),
+                    readThroughput > 0 ?
+                            std::to_string(readThroughput / (1024 * 1024)) :
+                            std::string("-"),
+                    degraded ? ltfsdm_messages[LTFSDMC0131I] : ltfsdm_messages[LTFSDMC0130I]);
     } while (id.compare("") != 0);
 
     return;
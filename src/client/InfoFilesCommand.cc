@@ -25,6 +25,8 @@
 #include <list>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include <sstream>
 #include <exception>
 
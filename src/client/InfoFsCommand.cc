@@ -25,6 +25,8 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include <vector>
 #include <list>
 #include <sstream>
@@ -22,6 +22,8 @@
 #include <list>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include <sstream>
 #include <exception>
 
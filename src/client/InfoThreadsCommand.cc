@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <sys/resource.h>
+
+#include <unistd.h>
+#include <string>
+#include <list>
+#include <sstream>
+#include <exception>
+
+#include "src/common/errors.h"
+#include "src/common/LTFSDMException.h"
+#include "src/common/Message.h"
+#include "src/common/Trace.h"
+
+#include "src/communication/ltfsdm.pb.h"
+#include "src/communication/LTFSDmComm.h"
+
+#include "LTFSDMCommand.h"
+#include "InfoThreadsCommand.h"
+
+/** @page ltfsdm_info_threads ltfsdm info threads
+    The ltfsdm info threads command provides statistics about the thread
+    pools of the LTFS Data Management server. For each thread pool the
+    maximum number of threads, the number of existing threads, the number
+    of threads executing a task, the number of tasks waiting for a thread
+    and the number of completed tasks is shown. The wait time and run time
+    rows show how many tasks waited respectively ran for the time given
+    in the column header.
+
+    <tt>@LTFSDMC0110I</tt>
+
+    parameters | description
+    ---|---
+    - | -
+
+    Example:
+
+    @verbatim
+    [root@visp ~]# ltfsdm info threads
+    thread pool          max       started   active    queued    completed
+    stub1-wq             64        2         0         0         1514
+                         <10us     <100us    <1ms      <10ms     <100ms    <1s       <10s      >=10s
+      wait time          0         1470      44        0         0         0         0         0
+      run time           0         0         12        1498      4         0         0         0
+    @endverbatim
+
+    The corresponding class is @ref InfoThreadsCommand.
+ */
+
+void InfoThreadsCommand::printUsage()
+{
+    INFO(LTFSDMC0110I);
+}
+
+void InfoThreadsCommand::doCommand(int argc, char **argv)
+{
+    processOptions(argc, argv);
+
+    TRACE(Trace::normal, *argv, argc, optind);
+
+    if (argc != optind) {
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    try {
+        connect();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0026E);
+        return;
+    }
+
+    LTFSDmProtocol::LTFSDmInfoThreadsRequest *infothreads =
+            commCommand.mutable_infothreadsrequest();
+
+    infothreads->set_key(key);
+
+    try {
+        commCommand.send();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0027E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    std::string name;
+
+    do {
+        try {
+            commCommand.recv();
+        } catch (const std::exception& e) {
+            MSG(LTFSDMC0028E);
+            THROW(Error::GENERAL_ERROR);
+        }
+
+        const LTFSDmProtocol::LTFSDmInfoThreadsResp infothreadsresp =
+                commCommand.infothreadsresp();
+        name = infothreadsresp.name();
+        if (name.compare("") == 0)
+            break;
+
+        // LTFSDMC0113I and LTFSDMC0114I provide one column for each bucket
+        static_assert(Const::THREAD_STATS_BUCKETS == 8,
+                "the output does not match the number of buckets");
+
+        if (infothreadsresp.waittime_size() != Const::THREAD_STATS_BUCKETS
+                || infothreadsresp.runtime_size()
+                        != Const::THREAD_STATS_BUCKETS) {
+            MSG(LTFSDMC0039E);
+            THROW(Error::GENERAL_ERROR);
+        }
+
+        INFO(LTFSDMC0111I);
+        INFO(LTFSDMC0112I, name, infothreadsresp.maxthreads(),
+                infothreadsresp.started(), infothreadsresp.active(),
+                infothreadsresp.queued(), infothreadsresp.completed());
+        INFO(LTFSDMC0113I);
+        INFO(LTFSDMC0114I, ltfsdm_messages[LTFSDMC0115I],
+                infothreadsresp.waittime(0), infothreadsresp.waittime(1),
+                infothreadsresp.waittime(2), infothreadsresp.waittime(3),
+                infothreadsresp.waittime(4), infothreadsresp.waittime(5),
+                infothreadsresp.waittime(6), infothreadsresp.waittime(7));
+        INFO(LTFSDMC0114I, ltfsdm_messages[LTFSDMC0116I],
+                infothreadsresp.runtime(0), infothreadsresp.runtime(1),
+                infothreadsresp.runtime(2), infothreadsresp.runtime(3),
+                infothreadsresp.runtime(4), infothreadsresp.runtime(5),
+                infothreadsresp.runtime(6), infothreadsresp.runtime(7));
+    } while (true);
+
+    return;
+}
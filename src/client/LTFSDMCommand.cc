@@ -22,6 +22,12 @@
 #include <fstream>
 #include <list>
 #include <set>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <sstream>
 #include <exception>
 
@@ -35,6 +41,7 @@
 #include "src/communication/LTFSDmComm.h"
 
 #include "LTFSDMCommand.h"
+#include "FileNameResolver.h"
 
 LTFSDMCommand::~LTFSDMCommand()
 
@@ -87,6 +94,9 @@ void LTFSDMCommand::processOptions(int argc, char **argv)
             case 'x':
                 forced = true;
                 break;
+            case 'd':
+                drain = true;
+                break;
             case 'F':
                 format = true;
                 break;
@@ -182,7 +192,7 @@ void LTFSDMCommand::sendObjects(std::stringstream *parmList)
 {
     std::istream *input;
     std::string line;
-    char *file_name;
+    std::string file_name;
     bool cont = true;
     int i;
     long startTime;
@@ -197,19 +207,22 @@ void LTFSDMCommand::sendObjects(std::stringstream *parmList)
         input = dynamic_cast<std::istream*>(parmList);
     }
 
+    FileNameResolver resolver(input);
+
+    // file lists are large, transfer them by shared memory if possible
+    commCommand.useSharedMemory();
+
     while (cont) {
         LTFSDmProtocol::LTFSDmSendObjects *sendobjects =
                 commCommand.mutable_sendobjects();
         LTFSDmProtocol::LTFSDmSendObjects::FileName* filenames;
 
         for (i = 0;
-                (i < Const::MAX_OBJECTS_SEND) && ((std::getline(*input, line)));
-                i++) {
-            file_name = canonicalize_file_name(line.c_str());
-            if (file_name) {
+                (i < Const::MAX_OBJECTS_SEND)
+                        && resolver.next(&line, &file_name); i++) {
+            if (file_name.compare("") != 0) {
                 filenames = sendobjects->add_filenames();
                 filenames->set_filename(file_name);
-                free(file_name);
                 count++;
             } else {
                 MSG(LTFSDMC0043E, line.c_str());
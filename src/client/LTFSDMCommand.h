@@ -37,6 +37,7 @@
  -P @<pool list@>      | a list of up to three tape storage pools (separated by commas)
  -t @<tape id@>        | the id of a cartridge
  -x                    | indicates a forced operation
+ -d                    | drain the request queue before stopping
  -F                    | format a cartridge when added to a tape storage pool
  -C                    | check a cartridge when added to a tape storage pool
 
@@ -126,7 +127,7 @@ protected:
                     Const::UNSET), fileList(""), command(command_), optionStr(
                     optionStr_), fsName(""), mountPoint(""), startTime(
                     time(NULL)), poolNames(""), tapeList( { }), forced(false), format(
-                    false), check(false), key(Const::UNSET), commCommand(
+                    false), check(false), drain(false), key(Const::UNSET), commCommand(
                     Const::CLIENT_SOCKET_FILE), resident(0), transferred(0), premigrated(
                     0), migrated(0), failed(0), not_all_exist(false)
     {
@@ -146,6 +147,7 @@ protected:
     bool forced;
     bool format;
     bool check;
+    bool drain;
     long key;
     LTFSDmCommClient commCommand;
     long resident;
@@ -22,6 +22,8 @@
 #include <sstream>
 #include <list>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include <exception>
 
 #include "src/common/errors.h"
@@ -156,6 +158,9 @@
     - the file names are send to the backend
     - the progress or results are queried
 
+    The file names are canonicalized in parallel before they are sent to
+    the backend, see @subpage file_name_resolver.
+
  */
 
 void MigrateCommand::printUsage()
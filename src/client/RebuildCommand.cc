@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <sys/resource.h>
+
+#include <stdlib.h>
+#include <string>
+#include <list>
+#include <sstream>
+#include <exception>
+
+#include "src/common/errors.h"
+#include "src/common/LTFSDMException.h"
+#include "src/common/Message.h"
+#include "src/common/Trace.h"
+
+#include "src/communication/ltfsdm.pb.h"
+#include "src/communication/LTFSDmComm.h"
+
+#include "LTFSDMCommand.h"
+#include "RebuildCommand.h"
+
+/** @page ltfsdm_rebuild ltfsdm rebuild
+    The ltfsdm rebuild command replaces the catalog entries of a cartridge
+    by the files found in an LTFS index of this cartridge. The index is
+    processed by the backend in a single pass without mounting the
+    cartridge. It can be captured e.g. by <tt>ltfsck --capture-index</tt>.
+    See @ref index_parser for more information.
+
+    <tt>@LTFSDMC0121I</tt>
+
+    parameters | description
+    ---|---
+    -t \<tape id\> | the cartridge for which the catalog should be rebuilt
+    -f \<LTFS index file\> | the file containing the LTFS index of the cartridge
+
+    Example:
+
+    @verbatim
+    [root@visp ~]# ltfsdm rebuild -t DV1462L6 -f /tmp/DV1462L6.schema
+    1000000 file(s) of cartridge DV1462L6 have been added to the catalog.
+    [root@visp ~]#
+    @endverbatim
+
+    The corresponding class is @ref RebuildCommand.
+ */
+
+void RebuildCommand::printUsage()
+{
+    INFO(LTFSDMC0121I);
+}
+
+void RebuildCommand::doCommand(int argc, char **argv)
+{
+    char *indexFile;
+
+    processOptions(argc, argv);
+
+    TRACE(Trace::normal, *argv, argc, optind);
+
+    if (argc != optind || tapeList.size() != 1 || fileList.compare("") == 0) {
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    // the backend does not run within the current directory
+    if ((indexFile = canonicalize_file_name(fileList.c_str())) == NULL) {
+        MSG(LTFSDMC0123E, tapeList.front(), fileList);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    fileList = indexFile;
+    free(indexFile);
+
+    try {
+        connect();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0026E);
+        return;
+    }
+
+    LTFSDmProtocol::LTFSDmRebuildRequest *rebuildreq =
+            commCommand.mutable_rebuildrequest();
+    rebuildreq->set_key(key);
+    rebuildreq->set_tapeid(tapeList.front());
+    rebuildreq->set_indexfile(fileList);
+
+    try {
+        commCommand.send();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0027E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    try {
+        commCommand.recv();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0028E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    const LTFSDmProtocol::LTFSDmRebuildResp rebuildresp =
+            commCommand.rebuildresp();
+
+    if (rebuildresp.error() != static_cast<long>(Error::OK)) {
+        MSG(LTFSDMC0123E, tapeList.front(), fileList);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    INFO(LTFSDMC0122I, rebuildresp.numfiles(), tapeList.front());
+}
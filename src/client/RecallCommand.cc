@@ -21,6 +21,8 @@
 #include <string>
 #include <list>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include <sstream>
 #include <exception>
 
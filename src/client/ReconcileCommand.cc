@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include <sys/resource.h>
+
+#include <string>
+#include <list>
+#include <sstream>
+#include <exception>
+
+#include "src/common/errors.h"
+#include "src/common/LTFSDMException.h"
+#include "src/common/Message.h"
+#include "src/common/Trace.h"
+
+#include "src/communication/ltfsdm.pb.h"
+#include "src/communication/LTFSDmComm.h"
+
+#include "LTFSDMCommand.h"
+#include "ReconcileCommand.h"
+
+/** @page ltfsdm_reconcile ltfsdm reconcile
+    The ltfsdm reconcile command compares the migration attributes of the
+    files of all managed file systems with the catalog of the backend.
+    It lists the references to tape copies that do not exist (dangling)
+    and the files on tape that are not referenced anymore (orphaned).
+    No cartridge is accessed. See @ref reconcile for more information.
+
+    <tt>@LTFSDMC0124I</tt>
+
+    parameters | description
+    ---|---
+    -x | remove the orphaned tape files from the catalog
+
+    Example:
+
+    @verbatim
+    [root@visp ~]# ltfsdm reconcile
+    type                 tape id              start block          size                 file name
+    dangling             DV1462L6             2061                 0                    /mnt/lxfs/test1/file.5
+    orphaned             DV1463L6             8198                 1073741824           /mnt/lxfs/test1/file.1
+    1 dangling reference(s), 1 orphaned tape file(s) with 1073741824 bytes.
+    [root@visp ~]#
+    @endverbatim
+
+    The corresponding class is @ref ReconcileCommand.
+ */
+
+void ReconcileCommand::printUsage()
+{
+    INFO(LTFSDMC0124I);
+}
+
+void ReconcileCommand::doCommand(int argc, char **argv)
+{
+    std::string type;
+    int error;
+    long numDangling = 0;
+    long numOrphaned = 0;
+    unsigned long orphanedSize = 0;
+
+    processOptions(argc, argv);
+
+    TRACE(Trace::normal, *argv, argc, optind);
+
+    if (argc != optind) {
+        printUsage();
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    try {
+        connect();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0026E);
+        return;
+    }
+
+    LTFSDmProtocol::LTFSDmReconcileRequest *reconcilereq =
+            commCommand.mutable_reconcilerequest();
+    reconcilereq->set_key(key);
+    reconcilereq->set_cleanup(forced);
+
+    try {
+        commCommand.send();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0027E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    INFO(LTFSDMC0125I);
+
+    do {
+        try {
+            commCommand.recv();
+        } catch (const std::exception& e) {
+            MSG(LTFSDMC0028E);
+            THROW(Error::GENERAL_ERROR);
+        }
+
+        const LTFSDmProtocol::LTFSDmReconcileResp reconcileresp =
+                commCommand.reconcileresp();
+        error = reconcileresp.error();
+        type = reconcileresp.type();
+        if (type.compare("") != 0) {
+            INFO(LTFSDMC0126I, type, reconcileresp.tapeid(),
+                    reconcileresp.startblock(), reconcileresp.filesize(),
+                    reconcileresp.filename());
+            if (type.compare(ltfsdm_messages[LTFSDMX0088I]) == 0) {
+                numDangling++;
+            } else {
+                numOrphaned++;
+                orphanedSize += reconcileresp.filesize();
+            }
+        }
+    } while (!exitClient && type.compare("") != 0);
+
+    if (error != static_cast<int>(Error::OK)) {
+        MSG(LTFSDMC0129E);
+        THROW(Error::GENERAL_ERROR);
+    }
+
+    INFO(LTFSDMC0127I, numDangling, numOrphaned, orphanedSize);
+
+    if (forced && numOrphaned > 0)
+        INFO(LTFSDMC0128I);
+}
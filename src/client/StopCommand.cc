@@ -42,6 +42,7 @@
     parameters | description
     ---|---
     -x | force the stop of LTFS Data Management even a managed file system is in use
+    -d | do not accept new requests but process all queued requests before stopping
 
     Example:
 
@@ -64,13 +65,13 @@
         LTFSDMCommand::connect
             LTFSDmCommClient::connect
             LTFSDMCommand::getRequestNumber
+        create stoprequest message
+        LTFSDmCommClient::send
         do
-            create stoprequest message
-            LTFSDmCommClient::send
             LTFSDmCommClient::recv
             if stopped == false
-                sleep 1
-        until stopped == false
+                print the number of outstanding requests
+        until stopped == true
         LTFS Data Management lock
         while locking fails
             sleep 1
@@ -94,14 +95,14 @@
                 connect2 [fontname="courier bold", fontcolor=dodgerblue4, label="LTFSDmCommClient::connect", URL="@ref LTFSDmCommClient::connect"];
                 get_req_num [fontname="courier bold", fontcolor=dodgerblue4, label="LTFSDMCommand::getRequestNumber", URL="@ref LTFSDMCommand::getRequestNumber"];
             }
+            create_message [label="create stoprequest message"];
+            send [fontname="courier bold", fontcolor=dodgerblue4, label="LTFSDmCommClient::send", URL="@ref LTFSDmCommClient::send"];
             subgraph cluster_loop_1 {
-                label="do until stopped == false";
-                create_message [label="create stoprequest message"];
-                send [fontname="courier bold", fontcolor=dodgerblue4, label="LTFSDmCommClient::send", URL="@ref LTFSDmCommClient::send"];
+                label="do until stopped == true";
                 recv [fontname="courier bold", fontcolor=dodgerblue4, label="LTFSDmCommClient::recv", URL="@ref LTFSDmCommClient::recv"];
                 subgraph cluster_condition {
                     label="if stopped == false";
-                    sleep_1 [label="sleep 1"];
+                    print_1 [label="print outstanding requests"];
                 }
             }
             lock_open [label="LTFS Data Management lock file"];
@@ -115,20 +116,24 @@
         process_options -> connect1 [];
         connect1 -> connect2 [lhead=cluster_connect,minlen=2];
         connect2 -> get_req_num [];
-        get_req_num -> create_message [ltail=cluster_connect,lhead=cluster_loop_1,minlen=2];
-        create_message -> send -> recv [];
-        recv -> sleep_1 [lhead=cluster_condition,minlen=2];
-        sleep_1 -> lock_open [ltail=cluster_loop_1,minlen=2];
+        get_req_num -> create_message [ltail=cluster_connect,minlen=2];
+        create_message -> send [];
+        send -> recv [lhead=cluster_loop_1,minlen=2];
+        recv -> print_1 [lhead=cluster_condition,minlen=2];
+        print_1 -> lock_open [ltail=cluster_loop_1,minlen=2];
         lock_open -> sleep_2 [lhead=cluster_loop_2,minlen=2];
         sleep_2 -> unlock [ltail=cluster_loop_2,minlen=2];
     }
     @enddot
 
     When processing the stop command at first a stoprequest message is sent to
-    the to the backend. If this fails it is repeated as long the backend does
-    not respond with success message. Thereafter the server lock is tried to
-    acquire to see that the server process is finally gone. The backend holds
-    a lock all the time it is operating.
+    the to the backend. The backend responds each time the number of requests
+    in progress or queued requests changes until all outstanding requests are
+    processed. Without the -d option only the requests in progress are
+    considered. With the -d option the backend does not accept new requests
+    but continues to schedule the queued ones. Thereafter the server lock is
+    tried to acquire to see that the server process is finally gone. The
+    backend holds a lock all the time it is operating.
  */
 
 void StopCommand::printUsage()
@@ -157,23 +162,27 @@ void StopCommand::doCommand(int argc, char **argv)
 
     TRACE(Trace::normal, requestNumber);
 
-    INFO(LTFSDMC0101I);
+    if (drain && !forced)
+        INFO(LTFSDMC0108I);
+    else
+        INFO(LTFSDMC0101I);
 
-    do {
-        LTFSDmProtocol::LTFSDmStopRequest *stopreq =
-                commCommand.mutable_stoprequest();
-        stopreq->set_key(key);
-        stopreq->set_reqnumber(requestNumber);
-        stopreq->set_forced(forced);
-        stopreq->set_finish(false);
+    LTFSDmProtocol::LTFSDmStopRequest *stopreq =
+            commCommand.mutable_stoprequest();
+    stopreq->set_key(key);
+    stopreq->set_reqnumber(requestNumber);
+    stopreq->set_forced(forced);
+    stopreq->set_finish(false);
+    stopreq->set_drain(drain);
 
-        try {
-            commCommand.send();
-        } catch (const std::exception& e) {
-            MSG(LTFSDMC0027E);
-            THROW(Error::GENERAL_ERROR);
-        }
+    try {
+        commCommand.send();
+    } catch (const std::exception& e) {
+        MSG(LTFSDMC0027E);
+        THROW(Error::GENERAL_ERROR);
+    }
 
+    do {
         try {
             commCommand.recv();
         } catch (const std::exception& e) {
@@ -185,13 +194,9 @@ void StopCommand::doCommand(int argc, char **argv)
 
         finished = stopresp.success();
 
-        if (!finished) {
-            INFO(LTFSDMC0103I);
-            sleep(1);
-        } else {
-            break;
-        }
-    } while (true);
+        if (!finished)
+            INFO(LTFSDMC0109I, stopresp.inprogress(), stopresp.queued());
+    } while (!finished);
 
     INFO(LTFSDMC0104I);
 
@@ -25,7 +25,7 @@ private:
     }
 public:
     StopCommand() :
-            LTFSDMCommand("stop", "hx")
+            LTFSDMCommand("stop", "hxd")
     {
     }
     ~StopCommand()
@@ -57,7 +57,11 @@
 #include "PoolAddCommand.h"
 #include "PoolRemoveCommand.h"
 #include "InfoPoolsCommand.h"
+#include "InfoThreadsCommand.h"
+#include "InfoCatalogCommand.h"
 #include "RetrieveCommand.h"
+#include "RebuildCommand.h"
+#include "ReconcileCommand.h"
 #include "VersionCommand.h"
 
 
@@ -218,6 +222,10 @@ int main(int argc, char *argv[])
         ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(new StatusCommand);
     } else if (RetrieveCommand().compare(command)) {
         ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(new RetrieveCommand);
+    } else if (RebuildCommand().compare(command)) {
+        ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(new RebuildCommand);
+    } else if (ReconcileCommand().compare(command)) {
+        ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(new ReconcileCommand);
     } else if (VersionCommand().compare(command)) {
         ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(new VersionCommand);
     } else if (InfoCommand().compare(command)) {
@@ -250,6 +258,12 @@ int main(int argc, char *argv[])
         } else if (InfoPoolsCommand().compare(command)) {
             ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(
                     new InfoPoolsCommand);
+        } else if (InfoThreadsCommand().compare(command)) {
+            ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(
+                    new InfoThreadsCommand);
+        } else if (InfoCatalogCommand().compare(command)) {
+            ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(
+                    new InfoCatalogCommand);
         } else {
             MSG(LTFSDMC0012E, command.c_str());
             ltfsdmCommand = std::unique_ptr<LTFSDMCommand>(new HelpCommand);
@@ -24,6 +24,8 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include <mutex>
 
 #include "src/common/errors.h"
@@ -36,6 +38,68 @@
 
 #include "Configuration.h"
 
+const std::set<std::string>& ConfigSnapshot::getPool(std::string poolName) const
+
+{
+    std::map<std::string, std::set<std::string>>::const_iterator it;
+
+    if ((it = pools.find(poolName)) == pools.end())
+        THROW(Error::CONFIG_POOL_NOT_EXISTS);
+
+    return it->second;
+}
+
+bool ConfigSnapshot::poolExists(std::string poolName) const
+
+{
+    return pools.find(poolName) != pools.end();
+}
+
+std::string ConfigSnapshot::getTapePool(std::string tapeId) const
+
+{
+    std::unordered_map<std::string, std::string>::const_iterator it;
+
+    if ((it = tapePool.find(tapeId)) == tapePool.end())
+        return "";
+
+    return it->second;
+}
+
+bool ConfigSnapshot::isInPool(std::string poolName, std::string tapeId) const
+
+{
+    std::unordered_map<std::string, std::string>::const_iterator it;
+
+    if ((it = tapePool.find(tapeId)) == tapePool.end())
+        return false;
+
+    return it->second.compare(poolName) == 0;
+}
+
+void Configuration::publish()
+
+{
+    std::shared_ptr<ConfigSnapshot> snap = std::make_shared<ConfigSnapshot>();
+
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    snap->version = std::atomic_load(&snapshot)->version + 1;
+    snap->pools = stgplist;
+    for (std::pair<std::string, std::set<std::string>> pool : stgplist)
+        for (std::string tapeId : pool.second)
+            snap->tapePool[tapeId] = pool.first;
+
+    std::atomic_store(&snapshot,
+            std::shared_ptr<const ConfigSnapshot>(std::move(snap)));
+}
+
+std::shared_ptr<const ConfigSnapshot> Configuration::getSnapshot()
+
+{
+    return std::atomic_load(&snapshot);
+}
+
 std::string Configuration::encode(std::string s)
 
 {
@@ -86,6 +150,8 @@ void Configuration::write()
 {
     std::lock_guard<std::recursive_mutex> lock(mtx);
 
+    publish();
+
     {
         std::ofstream conffiletmp(Const::TMP_CONFIG_FILE, conffiletmp.trunc);
 
@@ -104,6 +170,16 @@ void Configuration::write()
                     << fs.second.source << " " << fs.second.fstype << " "
                     << fs.second.options << " " << fs.second.uuid << std::endl;
         }
+
+        for (std::pair<std::string, std::string> affinity : affinities) {
+            conffiletmp << "affinity: " << encode(affinity.first) << " "
+                    << affinity.second << std::endl;
+        }
+
+        for (std::pair<std::string, unsigned long> cacheSize : recallCacheSizes) {
+            conffiletmp << "recallcache: " << encode(cacheSize.first) << " "
+                    << cacheSize.second << std::endl;
+        }
     }
 
     if (rename((Const::TMP_CONFIG_FILE).c_str(), (Const::CONFIG_FILE).c_str())
@@ -117,7 +193,10 @@ void Configuration::read()
     std::fstream conffile(Const::CONFIG_FILE);
     std::map<std::string, std::set<std::string>> stgplisttmp;
     std::map<std::string, fsinfo> fslisttmp;
+    std::map<std::string, std::string> affinitiestmp;
+    std::map<std::string, unsigned long> recallCacheSizestmp;
     std::string line;
+    std::string key;
     std::string poolName;
     std::string fsName;
     fsinfo finfo;
@@ -161,6 +240,28 @@ void Configuration::read()
             if (std::getline(liness, token, ' '))
                 THROW(Error::CONFIG_FORMAT_ERROR);
             fslisttmp[fsName] = finfo;
+        } else if (token.compare("affinity:") == 0) {
+            if (!std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            key = decode(token);
+            if (!std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            affinitiestmp[key] = token;
+            if (std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+        } else if (token.compare("recallcache:") == 0) {
+            if (!std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            fsName = decode(token);
+            if (!std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
+            try {
+                recallCacheSizestmp[fsName] = std::stoul(token);
+            } catch (const std::exception& e) {
+                THROW(Error::CONFIG_FORMAT_ERROR, token);
+            }
+            if (std::getline(liness, token, ' '))
+                THROW(Error::CONFIG_FORMAT_ERROR);
         } else {
             THROW(Error::CONFIG_FORMAT_ERROR);
         }
@@ -168,6 +269,10 @@ void Configuration::read()
 
     stgplist = stgplisttmp;
     fslist = fslisttmp;
+    affinities = affinitiestmp;
+    recallCacheSizes = recallCacheSizestmp;
+
+    publish();
 }
 
 void Configuration::poolCreate(std::string poolName)
@@ -211,9 +316,8 @@ void Configuration::poolAdd(std::string poolName, std::string tapeId)
     if ((it = stgplist.find(poolName)) == stgplist.end())
         THROW(Error::CONFIG_POOL_NOT_EXISTS);
 
-    for (std::pair<std::string, std::set<std::string>> pool : stgplist)
-        if (pool.second.find(tapeId) != pool.second.end())
-            THROW(Error::CONFIG_TAPE_EXISTS);
+    if (getSnapshot()->getTapePool(tapeId).compare("") != 0)
+        THROW(Error::CONFIG_TAPE_EXISTS);
 
     (*it).second.insert(tapeId);
 
@@ -242,24 +346,16 @@ void Configuration::poolRemove(std::string poolName, std::string tapeId)
 std::set<std::string> Configuration::getPool(std::string poolName)
 
 {
-    std::map<std::string, std::set<std::string>>::iterator it;
-
-    std::lock_guard<std::recursive_mutex> lock(mtx);
-
-    if ((it = stgplist.find(poolName)) == stgplist.end())
-        THROW(Error::CONFIG_POOL_NOT_EXISTS);
-
-    return it->second;
+    return getSnapshot()->getPool(poolName);
 }
 
 std::set<std::string> Configuration::getPools()
 
 {
     std::set<std::string> poolnames;
+    std::shared_ptr<const ConfigSnapshot> snap = getSnapshot();
 
-    std::lock_guard<std::recursive_mutex> lock(mtx);
-
-    for (std::pair<std::string, std::set<std::string>> pool : stgplist)
+    for (std::pair<std::string, std::set<std::string>> pool : snap->pools)
         poolnames.insert(pool.first);
 
     return poolnames;
@@ -320,3 +416,29 @@ std::set<std::string> Configuration::getFss()
 
     return fss;
 }
+
+std::string Configuration::getAffinity(std::string key)
+
+{
+    std::map<std::string, std::string>::iterator it;
+
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    if ((it = affinities.find(key)) == affinities.end())
+        return "";
+
+    return it->second;
+}
+
+unsigned long Configuration::getRecallCacheSize(std::string target)
+
+{
+    std::map<std::string, unsigned long>::iterator it;
+
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    if ((it = recallCacheSizes.find(target)) == recallCacheSizes.end())
+        return Const::RECALL_CACHE_SIZE;
+
+    return it->second;
+}
@@ -16,6 +16,37 @@
  *******************************************************************************/
 #pragma once
 
+/**
+    @brief Read-only view of the storage pool configuration.
+
+    @details
+    A snapshot is built each time the configuration is read or written
+    and is never modified afterwards. Callers can hold on to it and
+    query pool membership without taking the configuration lock. The
+    version is incremented with each new snapshot.
+ */
+class ConfigSnapshot
+{
+    friend class Configuration;
+private:
+    unsigned long version;
+    std::map<std::string, std::set<std::string>> pools;
+    std::unordered_map<std::string, std::string> tapePool;
+public:
+    ConfigSnapshot() :
+            version(0)
+    {
+    }
+    unsigned long getVersion() const
+    {
+        return version;
+    }
+    const std::set<std::string>& getPool(std::string poolName) const;
+    bool poolExists(std::string poolName) const;
+    std::string getTapePool(std::string tapeId) const;
+    bool isInPool(std::string poolName, std::string tapeId) const;
+};
+
 class Configuration
 {
 private:
@@ -28,13 +59,22 @@ private:
     };
     std::map<std::string, std::set<std::string>> stgplist;
     std::map<std::string, fsinfo> fslist;
+    std::map<std::string, std::string> affinities;
+    std::map<std::string, unsigned long> recallCacheSizes;
     void write();
     std::recursive_mutex mtx;
+    std::shared_ptr<const ConfigSnapshot> snapshot;
+    void publish();
 
     std::string encode(std::string s);
     std::string decode(std::string s);
 
 public:
+    Configuration() :
+            snapshot(std::make_shared<const ConfigSnapshot>())
+    {
+    }
+    std::shared_ptr<const ConfigSnapshot> getSnapshot();
     void read();
     void poolCreate(std::string poolName);
     void poolDelete(std::string poolName);
@@ -46,4 +86,7 @@ public:
     void addFs(FileSystems::fsinfo newfs);
     FileSystems::fsinfo getFs(std::string target);
     std::set<std::string> getFss();
+
+    std::string getAffinity(std::string key);
+    unsigned long getRecallCacheSize(std::string target);
 };
@@ -36,18 +36,44 @@ const std::string KEY_FILE = LTFSDM_TMP_DIR + DELIM + "LTFSDM.key";
 const std::string DB_FILE = LTFSDM_TMP_DIR + DELIM + "LTFSDM.db";
 const std::string CONFIG_FILE = "/etc/ltfsdm.conf";
 const std::string TMP_CONFIG_FILE = "/etc/ltfsdm.tmp.conf";
+const std::string MOUNTINFO_FILE = "/proc/self/mountinfo";
+const std::string CATALOG_DIR = "/var/lib/ltfsdm";
+const std::string CATALOG_FILE = CATALOG_DIR + DELIM + "catalog.db";
+const int CATALOG_BATCH_SIZE = 256;
+const int DB_BUSY_TIMEOUT = 60000;
+const unsigned long INDEX_RELEASE_SIZE = 64 * 1024 * 1024;
+const int RECONCILE_BATCH_SIZE = 10000;
+const int RECONCILE_OPEN_FDS = 64;
+const unsigned long DRIVE_PERF_SAMPLE_SIZE = 256 * 1024 * 1024;
+const double DRIVE_PERF_WEIGHT = 0.25;
+const int DRIVE_PERF_MIN_SAMPLES = 4;
+const double DRIVE_SLOW_RATIO = 0.5;
+const int DRIVE_ERROR_WINDOW = 100;
+const int DRIVE_ERROR_THRESHOLD = 5;
 //const std::string DB_FILE = ":memory:";
 const int MAX_RECEIVER_THREADS = 64;
 const int MAX_STUBBING_THREADS = 64;
+const int STUBBING_BATCH_SIZE = 32;
 const int MAX_PREMIG_THREADS = 16;
 const int MAX_TRANSPARENT_RECALL_THREADS = 8192;
 const std::chrono::seconds IDLE_THREAD_LIVE_TIME(10);
 const int MAX_OBJECTS_SEND = 100000;
+const unsigned long COMM_SHM_RING_SIZE = 32 * 1024 * 1024;
+const unsigned long COMM_SHM_MIN_SIZE = 64 * 1024;
+const int RESOLVER_THREADS = 16;
+const int RESOLVER_BATCH_SIZE = 256;
+const int RESOLVER_MAX_BATCHES = 256;
 const int MAX_FUSE_BACKGROUND = 256 * 1024;
+const int OVERLAY_START_TIMEOUT = 20;
+const std::chrono::milliseconds OVERLAY_STATFS_TTL(1000);
+const int MAX_MOUNT_THREADS = 8;
 const struct rlimit NOFILE_LIMIT = (struct rlimit ) { 1024 * 1024, 1024 * 1024 };
 const struct rlimit NPROC_LIMIT = (struct rlimit ) { 16 * 1024 * 1024, 16 * 1024
                 * 1024 };
 const std::string DMAPI_SESSION_NAME = "ltfsdm";
+const int DMAPI_MAX_EVENTS = 256;
+const int DMAPI_EVENT_BUFFER_SIZE = 256 * 1024;
+const int DMAPI_FUID_SHARDS = 64;
 const int LTFS_OPERATION_RETRY = 10;
 const std::string LTFS_NAME = "ltfsdm";
 const std::string LTFS_SYNC_VAL = "1";
@@ -56,7 +82,17 @@ const std::string DMAPI_ATTR_FS = "LTFSDMFS";
 const std::string LTFS_ATTR = "user.FILE_PATH";
 const std::string LTFS_START_BLOCK = "user.ltfs.startblock";
 const int READ_BUFFER_SIZE = 512 * 1024;
+const long PARALLEL_READ_MIN_SIZE = 256L * 1024 * 1024;
+const long PARALLEL_READ_CHUNK_SIZE = 8L * 1024 * 1024;
+const int PARALLEL_READERS = 4;
 const long UPDATE_SIZE = 200 * 1024 * 1024;
+const unsigned long INDEX_OVERHEAD_PER_FILE = 2 * 1024;
+const int MAX_INVENTORY_UPDATE_THREADS = 4;
+const unsigned long RECALL_CACHE_SIZE = 64UL * 1024 * 1024 * 1024;
+const int RECALL_CACHE_MIN_AGE = 300;
+const int RECALL_CACHE_INTERVAL = 10;
+const int RECALL_CACHE_OPEN_FDS = 64;
+const int THREAD_STATS_BUCKETS = 8;
 const int maxReplica = 3;
 const int tapeIdLength = 8;
 const std::string DMAPI_TERMINATION_MESSAGE = "termination message";
@@ -18,10 +18,14 @@
 #include <libmount/libmount.h>
 #include <blkid/blkid.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
 
 #include <string>
 #include <sstream>
 #include <vector>
+#include <mutex>
 
 #include "src/common/errors.h"
 #include "src/common/LTFSDMException.h"
@@ -31,6 +35,25 @@
 
 #include "FileSystems.h"
 
+/*
+ * The mount table is shared by all FileSystems objects of a process. It
+ * is parsed again only if the kernel reports a change of the mount table
+ * by a POLLPRI event on Const::MOUNTINFO_FILE or if the table has been
+ * invalidated by a mount or unmount operation of this process (the latter
+ * is necessary for fake mounts that only change the userspace table).
+ *
+ * A path cache is attached to each parsed table such that
+ * mnt_table_find_target also finds targets that are not specified in
+ * canonical form (e.g. with a symbolic link or a trailing slash). The
+ * cache is kept across the tables since it stays valid. It is not
+ * thread safe, therefore the lookups are performed with tableMutex held.
+ */
+static std::mutex tableMutex;
+static struct libmnt_table *sharedTable = NULL;
+static struct libmnt_cache *sharedCache = NULL;
+static int mountinfoFd = Const::UNSET;
+static bool tableStale = true;
+
 FileSystems::FileSystems() :
         first(true), tb(NULL)
 
@@ -48,6 +71,7 @@ FileSystems::FileSystems() :
 FileSystems::~FileSystems()
 
 {
+    mnt_unref_table(tb);
     blkid_put_cache(cache);
     mnt_free_context(cxt);
 }
@@ -55,13 +79,82 @@ FileSystems::~FileSystems()
 void FileSystems::getTable()
 
 {
+    struct libmnt_table *newtb;
+    struct pollfd pfd;
     int rc;
 
-    if ((rc = mnt_context_get_mtab(cxt, &tb)) != 0) {
-        blkid_put_cache(cache);
+    std::lock_guard<std::mutex> lock(tableMutex);
+
+    if (mountinfoFd == Const::UNSET) {
+        if ((mountinfoFd = open(Const::MOUNTINFO_FILE.c_str(),
+                O_RDONLY | O_CLOEXEC)) == -1) {
+            // without notification the table is parsed each time
+            TRACE(Trace::error, errno);
+            mountinfoFd = Const::UNSET;
+        }
+    }
+
+    if (sharedTable != NULL && tableStale == false
+            && mountinfoFd != Const::UNSET) {
+        pfd.fd = mountinfoFd;
+        pfd.events = POLLPRI;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 0) == 0) {
+            if (tb != sharedTable) {
+                mnt_ref_table(sharedTable);
+                mnt_unref_table(tb);
+                tb = sharedTable;
+            }
+            return;
+        }
+        // the poll consumed the event, keep it until the table is parsed
+        TRACE(Trace::normal, pfd.revents);
+        tableStale = true;
+    }
+
+    if (sharedCache == NULL && (sharedCache = mnt_new_cache()) == NULL) {
+        TRACE(Trace::error, errno);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    if ((newtb = mnt_new_table()) == NULL) {
+        TRACE(Trace::error, errno);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    mnt_table_set_cache(newtb, sharedCache);
+
+    if ((rc = mnt_table_parse_mtab(newtb, NULL)) != 0) {
+        mnt_unref_table(newtb);
         TRACE(Trace::error, rc, errno);
         THROW(Error::GENERAL_ERROR, rc, errno);
     }
+
+    mnt_unref_table(sharedTable);
+    sharedTable = newtb;
+    tableStale = false;
+
+    mnt_ref_table(sharedTable);
+    mnt_unref_table(tb);
+    tb = sharedTable;
+}
+
+void FileSystems::invalidateTable()
+
+{
+    std::lock_guard<std::mutex> lock(tableMutex);
+
+    tableStale = true;
+}
+
+struct libmnt_fs *FileSystems::findTarget(std::string target)
+
+{
+    getTable();
+
+    std::lock_guard<std::mutex> lock(tableMutex);
+
+    return mnt_table_find_target(tb, target.c_str(), MNT_ITER_BACKWARD);
 }
 
 FileSystems::fsinfo FileSystems::getContext(struct libmnt_fs *mntfs)
@@ -107,10 +200,7 @@ FileSystems::fsinfo FileSystems::getByTarget(std::string target)
     struct libmnt_fs *mntfs;
     fsinfo fs;
 
-    getTable();
-
-    if ((mntfs = mnt_table_find_target(tb, target.c_str(), MNT_ITER_BACKWARD))
-            == NULL) {
+    if ((mntfs = findTarget(target)) == NULL) {
         TRACE(Trace::error, target);
         THROW(Error::GENERAL_ERROR, target);
     }
@@ -136,8 +226,6 @@ void FileSystems::mount(std::string source, std::string target,
         THROW(Error::GENERAL_ERROR, target, rc);
     }
 
-    getTable();
-
     if (flag == FileSystems::MNT_FAKE) {
         if (mnt_context_enable_fake(cxt, TRUE) != 0) {
             TRACE(Trace::error, target, rc);
@@ -176,13 +264,17 @@ void FileSystems::mount(std::string source, std::string target,
         }
     }
 
-    if (mnt_context_mount(cxt) == 0)
+    if (mnt_context_mount(cxt) == 0) {
+        invalidateTable();
         return;
+    }
 
     if ((rc = mnt_context_get_status(cxt)) != 1) {
         TRACE(Trace::error, target, rc, mnt_context_get_syscall_errno(cxt));
         THROW(Error::GENERAL_ERROR, target, rc);
     }
+
+    invalidateTable();
 }
 
 void FileSystems::umount(std::string target, umountflag flag)
@@ -198,10 +290,7 @@ void FileSystems::umount(std::string target, umountflag flag)
         THROW(Error::GENERAL_ERROR, target, rc);
     }
 
-    getTable();
-
-    if ((mntfs = mnt_table_find_target(tb, target.c_str(), MNT_ITER_BACKWARD))
-            == NULL) {
+    if ((mntfs = findTarget(target)) == NULL) {
         TRACE(Trace::error, target);
         THROW(Error::GENERAL_ERROR, target);
     }
@@ -236,8 +325,10 @@ void FileSystems::umount(std::string target, umountflag flag)
         THROW(Error::GENERAL_ERROR, target, rc);
     }
 
-    if (mnt_context_umount(cxt) == 0)
+    if (mnt_context_umount(cxt) == 0) {
+        invalidateTable();
         return;
+    }
 
     if ((rc = mnt_context_get_status(cxt)) != 1) {
         err = mnt_context_get_syscall_errno(cxt);
@@ -247,4 +338,6 @@ void FileSystems::umount(std::string target, umountflag flag)
         else
             THROW(Error::GENERAL_ERROR, target, rc);
     }
+
+    invalidateTable();
 }
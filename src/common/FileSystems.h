@@ -42,6 +42,8 @@ private:
     blkid_cache cache;
     fsinfo getContext(struct libmnt_fs *mntfs);
     void getTable();
+    void invalidateTable();
+    struct libmnt_fs *findTarget(std::string target);
 public:
     enum umountflag
     {
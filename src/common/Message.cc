@@ -37,6 +37,20 @@
 
 Message messageObject;
 
+Message::Message() :
+        fd(Const::UNSET), fileName(Const::LOG_FILE), logType(Message::STDOUT)
+
+{
+    msgFormats.reserve(ltfsdm_msgnum);
+    infoFormats.reserve(ltfsdm_msgnum);
+
+    for (int i = 0; i < ltfsdm_msgnum; i++) {
+        msgFormats.push_back(
+                prepare(ltfsdm_msgname[i] + "(%04d): " + ltfsdm_messages[i]));
+        infoFormats.push_back(prepare(ltfsdm_messages[i]));
+    }
+}
+
 Message::~Message()
 
 {
@@ -46,6 +60,23 @@ Message::~Message()
     fd = Const::UNSET;
 }
 
+/*
+ * Parsing does not throw here: a malformed message text should not
+ * prevent a process from starting. Errors about the number of arguments
+ * are reported when formatting a copy of the returned object.
+ */
+boost::format Message::prepare(std::string fmtstr)
+
+{
+    boost::format fmter;
+
+    fmter.exceptions(boost::io::no_error_bits);
+    fmter.parse(fmtstr);
+    fmter.exceptions(boost::io::all_error_bits);
+
+    return fmter;
+}
+
 void Message::init(std::string extension)
 
 {
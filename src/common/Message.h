@@ -24,6 +24,7 @@
 #include <iostream>
 #include <iomanip>
 #include <mutex>
+#include <vector>
 
 #include "boost/format.hpp"
 
@@ -103,6 +104,14 @@
     <a href="http://www.boost.org/doc/libs/release/libs/format/">Boost Format library</a>
     is used to perform the formatting.
 
+    Parsing a format string is the most expensive part of the formatting.
+    Therefore all message texts are parsed once when the messaging object
+    is created. For each message a copy of the parsed format object is
+    taken and the arguments are fed into this copy. In addition the
+    message compiler determines the number of arguments of each message
+    (ltfsdm_msgargs). The MSG() and INFO() macros check at compile time
+    that the number of arguments provided matches the message text.
+
     For each process there exists a messaging object @ref messageObject to
     perform the message processing. This messaging object should not be
     used directly but is used internally as part of the MSG() and INFO()
@@ -139,8 +148,8 @@
         msg_log -> process_parms [];
         msg_out -> process_parms [];
         process_parms -> process_parms [];
-        process_parms -> write_log [label="boost::format fmter"];
-        process_parms -> write_out [label="boost::format fmter"];
+        process_parms -> write_log [label="boost::format fmter (copy)"];
+        process_parms -> write_out [label="boost::format fmter (copy)"];
         msg_log -> write_log [style=invis];
         msg_out -> write_out [style=invis];
         write_log -> result_log [];
@@ -163,6 +172,10 @@ public:
     };
 private:
     std::atomic<Message::LogType> logType;
+    std::vector<boost::format> msgFormats;
+    std::vector<boost::format> infoFormats;
+
+    static boost::format prepare(std::string fmtstr);
 
     inline void processParms(boost::format *fmter)
     {
@@ -186,10 +199,7 @@ private:
     void msgOut(ltfsdm_msg_id msg, char *filename, int linenr, Args ... args)
 
     {
-        std::string fmtstr = ltfsdm_msgname[msg] + "(%04d): "
-                + ltfsdm_messages[msg];
-        boost::format fmter(fmtstr);
-        fmter.exceptions(boost::io::all_error_bits);
+        boost::format fmter(msgFormats[msg]);
 
         try {
             fmter % linenr;
@@ -205,10 +215,7 @@ private:
     template<typename ... Args>
     void msgLog(ltfsdm_msg_id msg, char *filename, int linenr, Args ... args)
     {
-        std::string fmtstr = ltfsdm_msgname[msg] + "(%04d): "
-                + ltfsdm_messages[msg];
-        boost::format fmter(fmtstr);
-        fmter.exceptions(boost::io::all_error_bits);
+        boost::format fmter(msgFormats[msg]);
 
         try {
             fmter % linenr;
@@ -223,11 +230,7 @@ private:
     }
 
 public:
-    Message() :
-            fd(Const::UNSET), fileName(Const::LOG_FILE), logType(
-                    Message::STDOUT)
-    {
-    }
+    Message();
     ~Message();
 
     void init(std::string extension = "");
@@ -242,20 +245,25 @@ public:
         return logType;
     }
 
-    template<typename ... Args>
+    template<int N, typename ... Args>
     void message(ltfsdm_msg_id msg, char *filename, int linenr, Args ... args)
     {
+        static_assert(N == sizeof...(Args),
+                "number of arguments does not match the message text");
+
         if (logType == Message::STDOUT)
             msgOut(msg, filename, linenr, args ...);
         else
             msgLog(msg, filename, linenr, args ...);
     }
 
-    template<typename ... Args>
+    template<int N, typename ... Args>
     void info(ltfsdm_msg_id msg, char *filename, int linenr, Args ... args)
     {
-        boost::format fmter(ltfsdm_messages[msg]);
-        fmter.exceptions(boost::io::all_error_bits);
+        static_assert(N == sizeof...(Args),
+                "number of arguments does not match the message text");
+
+        boost::format fmter(infoFormats[msg]);
 
         try {
             processParms(&fmter, args ...);
@@ -271,5 +279,5 @@ public:
 
 extern Message messageObject;
 
-#define MSG(msg, args ...) messageObject.message(msg, (char *) __FILE__, __LINE__, ##args)
-#define INFO(msg, args ...) messageObject.info(msg, (char *) __FILE__, __LINE__, ##args)
+#define MSG(msg, args ...) messageObject.message<ltfsdm_msgargs[msg]>(msg, (char *) __FILE__, __LINE__, ##args)
+#define INFO(msg, args ...) messageObject.info<ltfsdm_msgargs[msg]>(msg, (char *) __FILE__, __LINE__, ##args)
@@ -15,7 +15,10 @@
  *
  *******************************************************************************/
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/resource.h>
@@ -34,6 +37,86 @@
 
 std::atomic<bool> exitClient(false);
 
+const int LTFSDmCommBuffer::SEALS = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+
+LTFSDmCommBuffer::LTFSDmCommBuffer() :
+        fd(Const::UNSET), addr(NULL), size(
+                DATA_OFFSET + 2 * Const::COMM_SHM_RING_SIZE)
+
+{
+    if ((fd = memfd_create("ltfsdm", MFD_CLOEXEC | MFD_ALLOW_SEALING))
+            == -1) {
+        TRACE(Trace::error, errno);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    if (ftruncate(fd, size) == -1
+            || fcntl(fd, F_ADD_SEALS, LTFSDmCommBuffer::SEALS) == -1) {
+        TRACE(Trace::error, errno);
+        close(fd);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    if ((addr = (char *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            fd, 0)) == MAP_FAILED) {
+        TRACE(Trace::error, errno);
+        close(fd);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    new (getTail(0)) std::atomic<unsigned long>(0);
+    new (getTail(1)) std::atomic<unsigned long>(0);
+}
+
+LTFSDmCommBuffer::LTFSDmCommBuffer(int _fd) :
+        fd(_fd), addr(NULL), size(DATA_OFFSET + 2 * Const::COMM_SHM_RING_SIZE)
+
+{
+    struct stat statbuf;
+    int seals;
+
+    // the size of the memory file must not change while it is mapped
+    if ((seals = fcntl(fd, F_GET_SEALS)) == -1
+            || (seals & LTFSDmCommBuffer::SEALS) != LTFSDmCommBuffer::SEALS) {
+        TRACE(Trace::error, errno, seals);
+        close(fd);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    if (fstat(fd, &statbuf) == -1 || (unsigned long) statbuf.st_size != size) {
+        TRACE(Trace::error, errno, size);
+        close(fd);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+
+    if ((addr = (char *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            fd, 0)) == MAP_FAILED) {
+        TRACE(Trace::error, errno);
+        close(fd);
+        THROW(Error::GENERAL_ERROR, errno);
+    }
+}
+
+LTFSDmCommBuffer::~LTFSDmCommBuffer()
+
+{
+    munmap(addr, size);
+    close(fd);
+}
+
+char *LTFSDmCommBuffer::getData(int ring)
+
+{
+    return addr + DATA_OFFSET + ring * Const::COMM_SHM_RING_SIZE;
+}
+
+std::atomic<unsigned long> *LTFSDmCommBuffer::getTail(int ring)
+
+{
+    // separate cache lines for both directions
+    return &((ring_t *) (addr + ring * 64))->tail;
+}
+
 void LTFSDmCommClient::connect()
 
 {
@@ -58,6 +141,22 @@ void LTFSDmCommClient::connect()
     GOOGLE_PROTOBUF_VERIFY_VERSION;
 }
 
+void LTFSDmCommClient::useSharedMemory()
+
+{
+    try {
+        shm = std::make_shared<LTFSDmCommBuffer>();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        return;
+    }
+
+    shmOwner = true;
+    shmReady = false;
+    shmSendFd = true;
+    shmHead = 0;
+}
+
 void LTFSDmCommServer::listen()
 
 {
@@ -97,13 +196,121 @@ void LTFSDmCommServer::accept()
     }
 }
 
+bool LTFSDmComm::shmReserve(unsigned long size, unsigned long *start)
+
+{
+    unsigned long pos = shmHead % Const::COMM_SHM_RING_SIZE;
+    unsigned long tail = shm->getTail(shmOwner ? 0 : 1)->load(
+            std::memory_order_acquire);
+
+    *start = shmHead;
+
+    // a message is not wrapped around the end of the ring
+    if (pos + size > Const::COMM_SHM_RING_SIZE)
+        *start += Const::COMM_SHM_RING_SIZE - pos;
+
+    if (size > Const::COMM_SHM_RING_SIZE
+            || *start + size - tail > Const::COMM_SHM_RING_SIZE)
+        return false;
+
+    shmHead = *start + size;
+
+    return true;
+}
+
+void LTFSDmComm::shmAttach(int shmFd)
+
+{
+    if (shmOwner || shm) {
+        TRACE(Trace::error, shmFd);
+        close(shmFd);
+        return;
+    }
+
+    try {
+        shm = std::make_shared<LTFSDmCommBuffer>(shmFd);
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        return;
+    }
+
+    shmReady = true;
+    shmHead = 0;
+}
+
+ssize_t LTFSDmComm::sendBuffer(int fd, char *buffer, unsigned long size)
+
+{
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    union
+    {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    int shmFd;
+
+    if (shmSendFd == false)
+        return write(fd, buffer, size);
+
+    shmSendFd = false;
+    shmFd = shm->getFd();
+
+    iov.iov_base = buffer;
+    iov.iov_len = size;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &shmFd, sizeof(int));
+
+    return sendmsg(fd, &msg, 0);
+}
+
 void LTFSDmComm::send(int fd)
 
 {
     unsigned long MessageSize;
     unsigned long rsize;
+    unsigned long header[2];
+    unsigned long flags = 0;
     char *buffer;
 
+    if (shm && shmOwner == false)
+        flags = SHM_ACCEPTED;
+
+    if (!exitClient && shm && shmReady
+            && (MessageSize = this->ByteSize()) >= Const::COMM_SHM_MIN_SIZE
+            && shmReserve(MessageSize, &header[1])) {
+        if (this->SerializeToArray(
+                shm->getData(shmOwner ? 0 : 1)
+                        + header[1] % Const::COMM_SHM_RING_SIZE, MessageSize)
+                == false) {
+            TRACE(Trace::error, MessageSize);
+            THROW(Error::GENERAL_ERROR);
+        }
+
+        header[0] = MessageSize | flags | SHM_MESSAGE;
+
+        TRACE(Trace::full, MessageSize, header[1]);
+
+        rsize = sendBuffer(fd, (char *) header, sizeof(header));
+
+        if (rsize != sizeof(header)) {
+            TRACE(Trace::error, rsize, MessageSize, errno);
+            MSG(LTFSDMX0008E);
+            THROW(Error::GENERAL_ERROR);
+        }
+
+        return;
+    }
+
     if (exitClient) {
         MessageSize = 0;
         buffer = (char *) malloc(sizeof(long));
@@ -113,7 +320,8 @@ void LTFSDmComm::send(int fd)
 
         buffer = (char *) malloc(MessageSize + sizeof(long));
         memset(buffer, 0, MessageSize + sizeof(long));
-        memcpy(buffer, &MessageSize, sizeof(long));
+        header[0] = MessageSize | flags;
+        memcpy(buffer, &header[0], sizeof(long));
         if (this->SerializeToArray(buffer + sizeof(long), MessageSize) == false) {
             TRACE(Trace::error, buffer);
             THROW(Error::GENERAL_ERROR);
@@ -122,7 +330,7 @@ void LTFSDmComm::send(int fd)
 
     TRACE(Trace::full, strlen(buffer), MessageSize);
 
-    rsize = write(fd, buffer, MessageSize + sizeof(long));
+    rsize = sendBuffer(fd, buffer, MessageSize + sizeof(long));
 
     if (rsize != 0 && rsize != MessageSize + sizeof(long)) {
         free(buffer);
@@ -157,25 +365,99 @@ ssize_t readx(int fd, char *buffer, size_t size)
     return bread;
 }
 
+ssize_t LTFSDmComm::recvHeader(int fd, unsigned long *header)
+
+{
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    union
+    {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    ssize_t rsize;
+    ssize_t remaining;
+    int shmFd;
+
+    iov.iov_base = header;
+    iov.iov_len = sizeof(long);
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    if ((rsize = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC)) <= 0) {
+        if (rsize == -1)
+            TRACE(Trace::error, errno);
+        return rsize;
+    }
+
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+            cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            memcpy(&shmFd, CMSG_DATA(cmsg), sizeof(int));
+            shmAttach(shmFd);
+        }
+    }
+
+    if (rsize < (ssize_t) sizeof(long)) {
+        remaining = readx(fd, (char *) header + rsize, sizeof(long) - rsize);
+        if (remaining == -1)
+            return -1;
+        rsize += remaining;
+    }
+
+    return rsize;
+}
+
 void LTFSDmComm::recv(int fd)
 
 {
+    unsigned long header;
+    unsigned long start;
     ssize_t MessageSize;
     ssize_t rsize;
     char *buffer;
+    int ring;
 
-    rsize = readx(fd, (char *) &MessageSize, sizeof(long));
+    rsize = recvHeader(fd, &header);
 
     if (rsize != sizeof(long)) {
         TRACE(Trace::error, rsize, sizeof(long));
         THROW(Error::GENERAL_ERROR);
     }
 
+    if ((header & SHM_ACCEPTED) && shmOwner)
+        shmReady = true;
+
+    MessageSize = header & ~(SHM_MESSAGE | SHM_ACCEPTED);
+
     if (MessageSize == 0)
         THROW(Error::GENERAL_ERROR);
 
     TRACE(Trace::full, MessageSize);
 
+    if (header & SHM_MESSAGE) {
+        rsize = readx(fd, (char *) &start, sizeof(long));
+
+        if (rsize != sizeof(long) || !shm
+                || start % Const::COMM_SHM_RING_SIZE + MessageSize
+                        > Const::COMM_SHM_RING_SIZE) {
+            TRACE(Trace::error, rsize, start, MessageSize);
+            THROW(Error::GENERAL_ERROR);
+        }
+
+        ring = shmOwner ? 1 : 0;
+        this->ParseFromArray(
+                shm->getData(ring) + start % Const::COMM_SHM_RING_SIZE,
+                MessageSize);
+        shm->getTail(ring)->store(start + MessageSize,
+                std::memory_order_release);
+        return;
+    }
+
     buffer = (char *) malloc(MessageSize);
     memset(buffer, 0, MessageSize);
 
@@ -18,13 +18,76 @@
 
 extern std::atomic<bool> exitClient;
 
+/** @page shared_memory_transport Shared Memory Transport
+
+    Messages are sent over a Unix domain socket. For large messages like
+    the file lists of the migrate and recall commands the payload
+    optionally is transferred by shared memory:
+
+    - The client creates a memory file (memfd) containing two rings of
+      Const::COMM_SHM_RING_SIZE bytes, one for each direction, by calling
+      LTFSDmCommClient::useSharedMemory. The file descriptor is passed
+      to the server as SCM_RIGHTS control message together with the next
+      message that is sent. The memory file is sealed against shrinking
+      and growing. The server rejects memory files without these seals
+      since accessing a mapping of a truncated file raises SIGBUS.
+    - After the server has mapped the memory file it indicates this by the
+      LTFSDmComm::SHM_ACCEPTED flag within the size field of each message
+      it sends. Before that the client does not use the ring.
+    - Messages of at least Const::COMM_SHM_MIN_SIZE bytes are serialized
+      directly into the ring. Only the size, together with the
+      LTFSDmComm::SHM_MESSAGE flag, and the position within the ring are
+      sent over the socket. The receiver parses the message from the ring
+      and thereafter releases the space by advancing the tail of the ring.
+    - If there is not enough free space in the ring the message is sent
+      over the socket as before. Therefore the sender never waits for the
+      receiver.
+
+ */
+
+class LTFSDmCommBuffer
+{
+private:
+    struct ring_t
+    {
+        std::atomic<unsigned long> tail;
+    };
+    static const unsigned long DATA_OFFSET = 4096;
+    static const int SEALS;
+    int fd;
+    char *addr;
+    unsigned long size;
+public:
+    LTFSDmCommBuffer();
+    LTFSDmCommBuffer(int _fd);
+    ~LTFSDmCommBuffer();
+    int getFd()
+    {
+        return fd;
+    }
+    char *getData(int ring);
+    std::atomic<unsigned long> *getTail(int ring);
+};
+
 class LTFSDmComm: public LTFSDmProtocol::Command
 {
 protected:
     std::string sockFile;
+    std::shared_ptr<LTFSDmCommBuffer> shm;
+    bool shmOwner;
+    bool shmReady;
+    bool shmSendFd;
+    unsigned long shmHead;
+    bool shmReserve(unsigned long size, unsigned long *start);
+    void shmAttach(int shmFd);
+    ssize_t sendBuffer(int fd, char *buffer, unsigned long size);
+    ssize_t recvHeader(int fd, unsigned long *header);
 public:
+    static const unsigned long SHM_MESSAGE = 1UL << 63;
+    static const unsigned long SHM_ACCEPTED = 1UL << 62;
     LTFSDmComm(const std::string _sockFile) :
-            sockFile(_sockFile)
+            sockFile(_sockFile), shm(nullptr), shmOwner(false), shmReady(
+                    false), shmSendFd(false), shmHead(0)
     {
     }
     ~LTFSDmComm()
@@ -50,6 +113,7 @@ public:
             close(socRefFd);
     }
     void connect();
+    void useSharedMemory();
     void send()
     {
         return LTFSDmComm::send(socRefFd);
@@ -242,6 +242,9 @@ public:
       FsObj::stat
     - to provide file file uid, see fuid_t\n
       FsObj::getfuid
+    - to provide a persistent file handle to reopen a file without
+      a path lookup, see FsObj::FsObj(std::string, std::string)\n
+      FsObj::getFileHandle
     - to provide the tape id of migrated and premigrated files\n
       FsObj::getTapeId
     - to lock file system objects\n
@@ -328,12 +331,14 @@ public:
     {
     }
     FsObj(std::string fileName);
+    FsObj(std::string fileName, std::string fileHandle);
     FsObj(Connector::rec_info_t recinfo);
     ~FsObj();
     bool isFsManaged();
     void manageFs(bool setDispo, struct timespec starttime);
     struct stat stat();
     fuid_t getfuid();
+    std::string getFileHandle();
     std::string getTapeId();
     void lock();
     bool try_lock();
@@ -30,6 +30,8 @@
 #include <typeinfo>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <exception>
@@ -62,9 +64,34 @@ struct conn_info_t
 	dm_token_t token;
 };
 
-std::map<fuid_t, int> fuidMap;
+struct fuid_hash
+{
+	size_t operator()(const fuid_t& fuid) const
+	{
+		return std::hash<unsigned long>()(fuid.inum)
+				^ (std::hash<unsigned long>()(fuid.fsid_l) << 1)
+				^ (std::hash<unsigned int>()(fuid.igen) << 2);
+	}
+};
+
+/* outstanding DMAPI rights per file, split to reduce lock contention */
+struct fuid_shard_t
+{
+	std::mutex mtx;
+	std::unordered_map<fuid_t, int, fuid_hash> fuidMap;
+};
+
+fuid_shard_t fuidShards[Const::DMAPI_FUID_SHARDS];
 
-std::mutex mtx;
+fuid_shard_t& getFuidShard(const fuid_t& fuid)
+
+{
+	return fuidShards[fuid_hash()(fuid) % Const::DMAPI_FUID_SHARDS];
+}
+
+/* events retrieved by dm_get_events that have not been processed yet */
+std::vector<char> eventBuf(Const::DMAPI_EVENT_BUFFER_SIZE);
+dm_eventmsg_t *nextEventMsgP = NULL;
 
 void dmapiSessionCleanup(dm_sessid_t *oldSid)
 
@@ -217,14 +244,14 @@ Connector::~Connector()
 {
 	try {
 		if (cleanup)
-			MSG(LTFSDMS0077I);
+			MSG(LTFSDMD0012I);
 		if (dm_respond_event(dmapiSession, dmapiToken, DM_RESP_ABORT, EINTR, 0,
 		NULL) == 1)
 			TRACE(Trace::error, errno);
 
 		dm_destroy_session(dmapiSession);
 		if (cleanup)
-			MSG(LTFSDMS0078I);
+			MSG(LTFSDMD0013I);
 	} catch (...) {
 		kill(getpid(), SIGTERM);
 	}
@@ -394,7 +421,6 @@ Connector::rec_info_t Connector::getEvents()
 {
 	rec_info_t recinfo;
 	dm_eventset_t eventSet;
-	char eventBuf[8192];
 	dm_eventmsg_t *eventMsgP;
 	dm_mount_event_t *mountEventP;
 	dm_data_event_t *dataEventP;
@@ -417,15 +443,23 @@ Connector::rec_info_t Connector::getEvents()
 
 	recinfo = (Connector::rec_info_t ) { 0, 0, (fuid_t) {0,0,0,0}, "" };
 
-	while (dm_get_events(dmapiSession, 1, DM_EV_WAIT, sizeof(eventBuf),
-			eventBuf, &rlen) == -1) {
-		TRACE(Trace::error, errno);
-		if ( errno != EINTR && errno != EAGAIN)
-			THROW(Error::GENERAL_ERROR, errno);
+	/* Fetch a new batch of events if all of the previous one are processed */
+	if (nextEventMsgP == NULL) {
+		while (dm_get_events(dmapiSession, Const::DMAPI_MAX_EVENTS, DM_EV_WAIT,
+				eventBuf.size(), eventBuf.data(), &rlen) == -1) {
+			TRACE(Trace::error, errno);
+			if (errno == E2BIG)
+				eventBuf.resize(rlen);
+			else if ( errno != EINTR && errno != EAGAIN)
+				THROW(Error::GENERAL_ERROR, errno);
+		}
+		TRACE(Trace::full, rlen);
+		nextEventMsgP = (dm_eventmsg_t *) eventBuf.data();
 	}
 
 	/* Process event */
-	eventMsgP = (dm_eventmsg_t *) eventBuf;
+	eventMsgP = nextEventMsgP;
+	nextEventMsgP = DM_STEP_TO_NEXT(eventMsgP, dm_eventmsg_t *);
 	token = eventMsgP->ev_token;
 
 	TRACE(Trace::normal, eventMsgP->ev_type);
@@ -545,8 +579,8 @@ Connector::rec_info_t Connector::getEvents()
 		case DM_EVENT_USER:
 			msg = DM_GET_VALUE(eventMsgP, ev_data, char *);
 			msglen = DM_GET_LEN(eventMsgP, ev_data);
-			msg[msglen] = 0;
-			MSG(LTFSDMD0008I, msg);
+			/* do not terminate in place, the next event may follow */
+			MSG(LTFSDMD0008I, std::string(msg, strnlen(msg, msglen)));
 			break;
 		default:
 			TRACE(Trace::error, eventMsgP->ev_type);
@@ -605,6 +639,31 @@ FsObj::FsObj(std::string fileName) :
 	}
 }
 
+FsObj::FsObj(std::string fileName, std::string fileHandle) :
+		handle(NULL), handleLength(0), isLocked(false), handleFree(true)
+
+{
+	std::stringstream sfh(fileHandle);
+	dm_fsid_t fsid;
+	dm_ino_t ino;
+	dm_igen_t igen;
+	char sep1, sep2;
+
+	sfh >> fsid >> sep1 >> ino >> sep2 >> igen;
+
+	if (sfh.fail() || sep1 != ':' || sep2 != ':'
+			|| dm_make_handle(&fsid, &ino, &igen, &handle, &handleLength) != 0) {
+		TRACE(Trace::normal, fileName, fileHandle);
+		handle = NULL;
+		handleLength = 0;
+		if (dm_path_to_handle((char *) fileName.c_str(), &handle,
+				&handleLength) != 0) {
+			TRACE(Trace::error, errno);
+			THROW(Error::GENERAL_ERROR, fileName);
+		}
+	}
+}
+
 FsObj::FsObj(Connector::rec_info_t recinfo) :
 		handle(NULL), handleLength(0), isLocked(false), handleFree(true)
 
@@ -766,14 +825,31 @@ fuid_t FsObj::getfuid()
 	return fuid;
 }
 
+std::string FsObj::getFileHandle()
+
+{
+	std::stringstream sfh;
+	fuid_t fuid;
+
+	if (handleLength == 0)
+		return "";
+
+	fuid = getfuid();
+	sfh << fuid.fsid_l << ":" << fuid.inum << ":" << fuid.igen;
+
+	return sfh.str();
+}
+
 void FsObj::lock()
 
 {
 	int rc;
 	fuid_t fuid = getfuid();
 	std::stringstream sstream;
+	fuid_shard_t& shard = getFuidShard(fuid);
+	std::unordered_map<fuid_t, int, fuid_hash>& fuidMap = shard.fuidMap;
 
-	std::unique_lock < std::mutex > lock(mtx);
+	std::unique_lock < std::mutex > lock(shard.mtx);
 
 	if (fuidMap.count(fuid) == 0) {
 		rc = dm_request_right(dmapiSession, handle, handleLength, dmapiToken,
@@ -804,8 +880,10 @@ void FsObj::unlock()
 	int rc;
 	fuid_t fuid = getfuid();
 	std::stringstream sstream;
+	fuid_shard_t& shard = getFuidShard(fuid);
+	std::unordered_map<fuid_t, int, fuid_hash>& fuidMap = shard.fuidMap;
 
-	std::unique_lock < std::mutex > lock(mtx);
+	std::unique_lock < std::mutex > lock(shard.mtx);
 
 	if (isLocked == false) {
 		TRACE(Trace::error, isLocked);
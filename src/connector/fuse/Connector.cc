@@ -25,6 +25,8 @@
 #include <sstream>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <memory>
 #include <vector>
 #include <thread>
 
@@ -191,6 +193,10 @@
     - If a file system has been added previously: during the startup phase
       of LTFS Data management done automatically.
 
+    During startup up to Const::MAX_MOUNT_THREADS file systems are brought
+    under management in parallel (see TransRecall::manageFs). Each file
+    system reports when it is ready.
+
     The following two methods are involved when managing a file system:
     @code
     FsObj::manageFs
@@ -29,8 +29,11 @@
 
 #include <string>
 #include <sstream>
+#include <iomanip>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include <vector>
 #include <thread>
 
@@ -99,8 +102,7 @@
  handleLength = sizeof(FuseFS::FuseHandle);
  }*/
 
-FsObj::FsObj(std::string fileName) :
-        handle(NULL), handleLength(0), isLocked(false), handleFree(true)
+static FuseFS::FuseHandle *openByName(std::string fileName)
 
 {
     FuseFS::FuseHandle *fh = new FuseFS::FuseHandle();
@@ -115,6 +117,7 @@ FsObj::FsObj(std::string fileName) :
         strncpy(fh->mountpoint, fileName.c_str(), PATH_MAX - 1);
         fh->fd = Const::UNSET;
     } else {
+        std::unique_lock<std::mutex> lock(FuseConnector::mtx);
         std::map<std::string, std::unique_ptr<FuseFS>>::iterator search =
                 FuseConnector::managedFss.find(fh->mountpoint);
         if (search == FuseConnector::managedFss.end()) {
@@ -143,6 +146,111 @@ FsObj::FsObj(std::string fileName) :
         }
     }
 
+    return fh;
+}
+
+/*
+ * The file handle string is provided by FsObj::getFileHandle and has the
+ * format <fsid_h>:<fsid_l>:<handle type>:<handle bytes (hex)>:<mount point>.
+ * If the file cannot be opened by its handle nullptr is returned and the
+ * caller falls back to the path lookup.
+ */
+static FuseFS::FuseHandle *openByHandle(std::string fileName,
+        std::string fileHandle)
+
+{
+    FuseFS::FuseHandle *fh;
+    std::stringstream sfh(fileHandle);
+    std::string field[4];
+    std::string mountpoint;
+    std::stringstream lpath;
+    std::unique_ptr<char[]> buf(
+            new char[sizeof(struct file_handle) + MAX_HANDLE_SZ]);
+    struct file_handle *fhandle = (struct file_handle *) buf.get();
+    struct stat statbuf;
+    unsigned long fsid_h;
+    unsigned long fsid_l;
+    int fd;
+
+    try {
+        for (int i = 0; i < 4; i++)
+            if (!std::getline(sfh, field[i], ':'))
+                return nullptr;
+        std::getline(sfh, mountpoint);
+
+        fsid_h = std::stoul(field[0]);
+        fsid_l = std::stoul(field[1]);
+        fhandle->handle_type = std::stoi(field[2]);
+        fhandle->handle_bytes = field[3].size() / 2;
+
+        if (fhandle->handle_bytes == 0 || fhandle->handle_bytes > MAX_HANDLE_SZ
+                || fileName.compare(0, mountpoint.size() + 1,
+                        mountpoint + "/") != 0)
+            return nullptr;
+
+        for (unsigned int i = 0; i < fhandle->handle_bytes; i++)
+            fhandle->f_handle[i] = std::stoul(field[3].substr(2 * i, 2),
+                    nullptr, 16);
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, fileHandle, e.what());
+        return nullptr;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(FuseConnector::mtx);
+        std::map<std::string, std::unique_ptr<FuseFS>>::iterator search =
+                FuseConnector::managedFss.find(mountpoint);
+        if (search == FuseConnector::managedFss.end())
+            return nullptr;
+
+        if ((fd = open_by_handle_at(search->second->getRootFd(), fhandle,
+        O_RDWR)) == -1 && errno == EISDIR)
+            fd = open_by_handle_at(search->second->getRootFd(), fhandle,
+            O_RDONLY);
+    }
+
+    if (fd == -1) {
+        TRACE(Trace::normal, fileName, errno);
+        return nullptr;
+    }
+
+    if (fstat(fd, &statbuf) == -1) {
+        TRACE(Trace::error, fileName, errno);
+        close(fd);
+        return nullptr;
+    }
+
+    lpath << mountpoint << Const::LTFSDM_LOCK_DIR << "/" << statbuf.st_ino;
+
+    fh = new FuseFS::FuseHandle();
+    strncpy(fh->fusepath, fileName.substr(mountpoint.size() + 1).c_str(),
+    PATH_MAX - 1);
+    strncpy(fh->mountpoint, mountpoint.c_str(), PATH_MAX - 1);
+    strncpy(fh->lockpath, lpath.str().c_str(), PATH_MAX - 1);
+    fh->fsid_h = fsid_h;
+    fh->fsid_l = fsid_l;
+    fh->fd = fd;
+
+    return fh;
+}
+
+FsObj::FsObj(std::string fileName) :
+        FsObj::FsObj(fileName, "")
+{
+}
+
+FsObj::FsObj(std::string fileName, std::string fileHandle) :
+        handle(NULL), handleLength(0), isLocked(false), handleFree(true)
+
+{
+    FuseFS::FuseHandle *fh = nullptr;
+
+    if (fileHandle.compare("") != 0)
+        fh = openByHandle(fileName, fileHandle);
+
+    if (fh == nullptr)
+        fh = openByName(fileName);
+
     fh->ffd = Const::UNSET;
 
     handle = (void *) fh;
@@ -194,22 +302,27 @@ void FsObj::manageFs(bool setDispo, struct timespec starttime)
 
 {
     FuseFS::FuseHandle *fh = (FuseFS::FuseHandle *) handle;
+    FuseFS *fusefs;
 
     TRACE(Trace::always, fh->mountpoint);
 
-    FuseConnector::managedFss.emplace(fh->mountpoint,
-            std::unique_ptr<FuseFS>(new FuseFS(fh->mountpoint)));
+    // file systems may be added in parallel, only the map is protected
+    {
+        std::unique_lock<std::mutex> lock(FuseConnector::mtx);
+        FuseConnector::managedFss.emplace(fh->mountpoint,
+                std::unique_ptr<FuseFS>(new FuseFS(fh->mountpoint)));
+        fusefs = FuseConnector::managedFss[fh->mountpoint].get();
+    }
 
     try {
-        FuseConnector::managedFss[fh->mountpoint]->init(starttime);
+        fusefs->init(starttime);
     } catch (const std::exception& e) {
         TRACE(Trace::error, e.what());
+        std::unique_lock<std::mutex> lock(FuseConnector::mtx);
         FuseConnector::managedFss.erase(
                 FuseConnector::managedFss.find(fh->mountpoint));
         THROW(Error::GENERAL_ERROR);
     }
-
-    std::unique_lock<std::mutex> lock(FuseConnector::mtx);
 }
 
 struct stat FsObj::stat()
@@ -269,6 +382,37 @@ std::string FsObj::getTapeId()
     return "";
 }
 
+std::string FsObj::getFileHandle()
+
+{
+    FuseFS::FuseHandle *fh = (FuseFS::FuseHandle *) handle;
+    std::unique_ptr<char[]> buf(
+            new char[sizeof(struct file_handle) + MAX_HANDLE_SZ]);
+    struct file_handle *fhandle = (struct file_handle *) buf.get();
+    std::stringstream sfh;
+    int mountId;
+
+    if (fh->fd == Const::UNSET)
+        return "";
+
+    fhandle->handle_bytes = MAX_HANDLE_SZ;
+
+    // file systems not supporting file handles are accessed by path
+    if (name_to_handle_at(fh->fd, "", fhandle, &mountId, AT_EMPTY_PATH)
+            == -1) {
+        TRACE(Trace::normal, fh->fusepath, errno);
+        return "";
+    }
+
+    sfh << fh->fsid_h << ":" << fh->fsid_l << ":" << fhandle->handle_type
+            << ":" << std::hex << std::setfill('0');
+    for (unsigned int i = 0; i < fhandle->handle_bytes; i++)
+        sfh << std::setw(2) << (unsigned int) fhandle->f_handle[i];
+    sfh << ":" << fh->mountpoint;
+
+    return sfh.str();
+}
+
 void FsObj::lock()
 
 {
@@ -333,7 +477,7 @@ long FsObj::read(long offset, unsigned long size, char *buffer)
 {
     long rsize = 0;
     FuseFS::FuseHandle *fh = (FuseFS::FuseHandle *) handle;
-    rsize = ::read(fh->fd, buffer, size);
+    rsize = ::pread(fh->fd, buffer, size, offset);
 
     if (rsize == -1) {
         TRACE(Trace::error, errno);
@@ -509,17 +653,11 @@ void FsObj::stub()
 
 {
     FuseFS::FuseHandle *fh = (FuseFS::FuseHandle *) handle;
-    struct stat statbuf;
     std::stringstream spath;
     int fd;
 
     spath << fh->mountpoint << "/" << fh->fusepath;
 
-    if (fstat(fh->fd, &statbuf) == -1) {
-        TRACE(Trace::error, errno);
-        THROW(Error::GENERAL_ERROR, errno, fh->fusepath);
-    }
-
     if (ftruncate(fh->fd, 0) == -1) {
         TRACE(Trace::error, errno);
         MSG(LTFSDMF0016E, fh->fusepath);
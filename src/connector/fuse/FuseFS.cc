@@ -20,6 +20,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/stat.h>
 #include <sys/mount.h>
 #include <linux/fs.h>
@@ -39,11 +40,14 @@
 #include <sstream>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include <vector>
 #include <atomic>
 #include <condition_variable>
 #include <thread>
 #include <mutex>
+#include <chrono>
 #include <exception>
 
 #include "src/common/errors.h"
@@ -63,6 +67,13 @@
 #include "src/connector/fuse/FuseFS.h"
 
 std::mutex FuseFS::mask_mutex;
+std::mutex FuseFS::spawn_mutex;
+
+std::mutex FuseFS::statfs_mutex;
+struct statvfs FuseFS::statfsCache;
+unsigned long FuseFS::statfsGeneration = 0;
+std::chrono::steady_clock::time_point FuseFS::statfsExpiry;
+std::atomic<unsigned long> FuseFS::fsGeneration(0);
 
 const char *FuseFS::relPath(const char *path)
 
@@ -615,6 +626,7 @@ int FuseFS::ltfsdm_releasedir(const char *path, struct fuse_file_info *finfo)
 int FuseFS::ltfsdm_mknod(const char *path, mode_t mode, dev_t rdev)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     struct fuse_context *fc = fuse_get_context();
 
     std::lock_guard<std::mutex> lock(mask_mutex);
@@ -637,6 +649,7 @@ int FuseFS::ltfsdm_mknod(const char *path, mode_t mode, dev_t rdev)
 int FuseFS::ltfsdm_mkdir(const char *path, mode_t mode)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     struct fuse_context *fc = fuse_get_context();
 
     std::lock_guard<std::mutex> lock(mask_mutex);
@@ -659,6 +672,7 @@ int FuseFS::ltfsdm_mkdir(const char *path, mode_t mode)
 int FuseFS::ltfsdm_unlink(const char *path)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     if (unlinkat(getshrd()->rootFd, FuseFS::relPath(path), 0) == -1)
         return (-1 * errno);
     else
@@ -668,6 +682,7 @@ int FuseFS::ltfsdm_unlink(const char *path)
 int FuseFS::ltfsdm_rmdir(const char *path)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     if (unlinkat(getshrd()->rootFd, FuseFS::relPath(path), AT_REMOVEDIR) == -1)
         return (-1 * errno);
     else
@@ -677,6 +692,7 @@ int FuseFS::ltfsdm_rmdir(const char *path)
 int FuseFS::ltfsdm_symlink(const char *target, const char *linkpath)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     struct fuse_context *fc = fuse_get_context();
 
     if (symlinkat(target, getshrd()->rootFd, FuseFS::relPath(linkpath)) == -1) {
@@ -743,6 +759,7 @@ int FuseFS::ltfsdm_chown(const char *path, uid_t uid, gid_t gid)
 int FuseFS::ltfsdm_truncate(const char *path, off_t size)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     FuseFS::mig_state_attr_t migInfo;
     ssize_t attrsize;
     FuseFS::ltfsdm_file_info linfo = (FuseFS::ltfsdm_file_info ) { 0, 0, "" };
@@ -896,6 +913,7 @@ int FuseFS::ltfsdm_ftruncate(const char *path, off_t size,
         struct fuse_file_info *finfo)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     FuseFS::mig_state_attr_t migInfo;
     ssize_t attrsize;
     FuseFS::ltfsdm_file_info *linfo = (FuseFS::ltfsdm_file_info *) finfo->fh;
@@ -1019,6 +1037,7 @@ int FuseFS::ltfsdm_write_buf(const char *path, struct fuse_bufvec *buf,
         off_t offset, struct fuse_file_info *finfo)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     ssize_t wsize;
     FuseFS::mig_state_attr_t migInfo;
     ssize_t attrsize;
@@ -1089,6 +1108,16 @@ int FuseFS::ltfsdm_statfs(const char *path, struct statvfs *stbuf)
 
 {
     int fd;
+    std::lock_guard<std::mutex> lock(statfs_mutex);
+    unsigned long generation = fsGeneration;
+    std::chrono::steady_clock::time_point now =
+            std::chrono::steady_clock::now();
+
+    // concurrent callers wait for a single refresh
+    if (statfsGeneration == generation && now < statfsExpiry) {
+        *stbuf = statfsCache;
+        return 0;
+    }
 
     if ((fd = openat(getshrd()->rootFd, FuseFS::relPath(path), O_RDONLY)) == -1)
         return (-1 * errno);
@@ -1098,6 +1127,9 @@ int FuseFS::ltfsdm_statfs(const char *path, struct statvfs *stbuf)
         return (-1 * errno);
     } else {
         close(fd);
+        statfsCache = *stbuf;
+        statfsGeneration = generation;
+        statfsExpiry = now + Const::OVERLAY_STATFS_TTL;
         return 0;
     }
 }
@@ -1185,6 +1217,7 @@ int FuseFS::ltfsdm_fallocate(const char *path, int mode, off_t offset,
         off_t length, struct fuse_file_info *finfo)
 
 {
+    FuseFS::statfs_invalidator invalidator;
     FuseFS::ltfsdm_file_info *linfo = (FuseFS::ltfsdm_file_info *) finfo->fh;
 
     assert(path == NULL);
@@ -1399,10 +1432,20 @@ void *FuseFS::ltfsdm_init(struct fuse_conn_info *conn)
 
 {
     struct fuse_context *fc = fuse_get_context();
+    FuseFS::shared_data *sd = (FuseFS::shared_data *) fc->private_data;
+    char ready = 1;
 
     conn->want |= FUSE_CAP_BIG_WRITES;
     conn->want |= FUSE_CAP_DONT_MASK;
 
+    // the file system is mounted, tell the backend to continue
+    if (sd->readyFd != Const::UNSET) {
+        if (write(sd->readyFd, &ready, sizeof(ready)) == -1)
+            TRACE(Trace::error, errno);
+        close(sd->readyFd);
+        sd->readyFd = Const::UNSET;
+    }
+
     return fc->private_data;
 }
 
@@ -1465,20 +1508,13 @@ struct fuse_operations FuseFS::init_operations()
     return ops;
 }
 
-void FuseFS::execute(std::string sourcedir, std::string mountpt,
-        std::string command)
+void FuseFS::execute(std::string sourcedir, std::string mountpt, FILE *cmd)
 
 {
     pthread_setname_np(pthread_self(), "ltfsdmd.ofs");
     int ret;
     char c;
     std::string line;
-    FILE *cmd;
-
-    if ((cmd = popen(command.c_str(), "re")) == NULL) {
-        MSG(LTFSDMF0058E, mountpt);
-        return;
-    }
 
     while (!feof(cmd)) {
         if ((c = fgetc(cmd)) != 0) {
@@ -1544,6 +1580,33 @@ std::string FuseFS::mask(std::string s)
     return masked;
 }
 
+bool FuseFS::waitReady(int readyFd)
+
+{
+    struct pollfd pfd = { readyFd, POLLIN, 0 };
+    char ready;
+    int rc;
+
+    MSG(LTFSDMF0041I);
+
+    while ((rc = poll(&pfd, 1, Const::OVERLAY_START_TIMEOUT * 1000)) == -1
+            && errno == EINTR)
+        ;
+
+    if (rc != 1) {
+        TRACE(Trace::error, rc, errno);
+        return false;
+    }
+
+    // zero bytes read: the overlay process terminated without being mounted
+    if (read(readyFd, &ready, sizeof(ready)) != sizeof(ready)) {
+        TRACE(Trace::error, errno);
+        return false;
+    }
+
+    return true;
+}
+
 /**
     @brief Setup of LTFS Data Management for a file system.
     @details
@@ -1559,7 +1622,9 @@ std::string FuseFS::mask(std::string s)
     -# Start of the Fuse overlay file system. The Fuse overlay file system
        is mounted at the original mount point.
     -# Wait for the Fuse overlay file system to be  in operation and open a
-       file descriptor for the ioctl communication.
+       file descriptor for the ioctl communication. The Fuse process writes
+       to a pipe within FuseFS::ltfsdm_init after it has been mounted
+       (see FuseFS::waitReady) instead of being polled for.
     -# Mount the original file system within the cache mount point
        Const::LTFSDM_CACHE_MP.
     -# Open the file descriptor FuseFS::rootFd on its root: i.e.
@@ -1584,7 +1649,9 @@ void FuseFS::init(struct timespec starttime)
     std::stringstream stream;
     char exepath[PATH_MAX];
     int fd = Const::UNSET;
-    int count = 0;
+    int readyPipe[2];
+    FILE *cmd;
+    bool ready;
     FileSystems fss;
     FileSystems::fsinfo fs;
     bool alreadyManaged = false;
@@ -1648,42 +1715,60 @@ void FuseFS::init(struct timespec starttime)
             THROW(Error::GENERAL_ERROR);
     }
 
-    stream << mask(dirname(exepath)) << "/" << Const::OVERLAY_FS_COMMAND
-            << " -m " << mask(mountpt) << " -f " << mask(fs.source) << " -S "
-            << starttime.tv_sec << " -N " << starttime.tv_nsec << " -l "
-            << messageObject.getLogType() << " -t " << traceObject.getTrclevel()
-            << " -p " << getpid() << " 2>&1";
-    TRACE(Trace::always, stream.str());
-    thrd = new std::thread(&FuseFS::execute, (mountpt + Const::LTFSDM_CACHE_MP),
-            mountpt, stream.str());
+    {
+        // File systems are started in parallel. The write end must not be
+        // inherited by the Fuse process of another file system: it only
+        // is inheritable while this Fuse process is started.
+        std::lock_guard<std::mutex> lock(spawn_mutex);
 
-    while (true) {
-        if ((fd = open((mountpt + Const::LTFSDM_IOCTL).c_str(),
-        O_RDONLY | O_CLOEXEC)) == -1) {
-            if (count < 20) {
-                MSG(LTFSDMF0041I);
-                sleep(1);
-                count++;
-                continue;
-            }
-            thrd->join();
-            delete (thrd);
+        if (pipe2(readyPipe, O_CLOEXEC) == -1) {
             MSG(LTFSDMF0040E, errno);
             THROW(Error::GENERAL_ERROR);
-        } else if (ioctl(fd, FuseFS::LTFSDM_PREMOUNT) != -1) {
-            break;
-        } else if (count < 20) {
-            MSG(LTFSDMF0041I);
-            close(fd);
-            sleep(1);
-            count++;
-        } else {
-            close(fd);
-            thrd->join();
-            delete (thrd);
+        }
+
+        if (fcntl(readyPipe[1], F_SETFD, 0) == -1) {
             MSG(LTFSDMF0040E, errno);
+            close(readyPipe[0]);
+            close(readyPipe[1]);
             THROW(Error::GENERAL_ERROR);
         }
+
+        stream << mask(dirname(exepath)) << "/" << Const::OVERLAY_FS_COMMAND
+                << " -m " << mask(mountpt) << " -f " << mask(fs.source)
+                << " -S " << starttime.tv_sec << " -N " << starttime.tv_nsec
+                << " -l " << messageObject.getLogType() << " -t "
+                << traceObject.getTrclevel() << " -p " << getpid() << " -r "
+                << readyPipe[1] << " 2>&1";
+        TRACE(Trace::always, stream.str());
+
+        cmd = popen(stream.str().c_str(), "re");
+
+        // only the overlay process should keep the write end open
+        close(readyPipe[1]);
+
+        if (cmd == NULL) {
+            MSG(LTFSDMF0058E, mountpt);
+            close(readyPipe[0]);
+            THROW(Error::GENERAL_ERROR);
+        }
+    }
+
+    thrd = new std::thread(&FuseFS::execute, (mountpt + Const::LTFSDM_CACHE_MP),
+            mountpt, cmd);
+
+    ready = waitReady(readyPipe[0]);
+    close(readyPipe[0]);
+
+    if (ready == false
+            || (fd = open((mountpt + Const::LTFSDM_IOCTL).c_str(),
+            O_RDONLY | O_CLOEXEC)) == -1
+            || ioctl(fd, FuseFS::LTFSDM_PREMOUNT) == -1) {
+        MSG(LTFSDMF0040E, errno);
+        if (fd != Const::UNSET)
+            close(fd);
+        thrd->join();
+        delete (thrd);
+        THROW(Error::GENERAL_ERROR);
     }
 
     init_status.FUSE_STARTED = true;
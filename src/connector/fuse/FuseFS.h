@@ -70,6 +70,18 @@
     }
     @enddot
 
+    FuseFS::ltfsdm_statfs does not forward each call to the source file
+    system. Tools like df or backup scanners call statfs frequently and
+    on network file systems each call costs a round trip. The result is
+    cached for Const::OVERLAY_STATFS_TTL. Call backs that change the
+    space or inode usage (write, truncate, fallocate, create, and remove)
+    increment a generation counter by a FuseFS::statfs_invalidator
+    when they return. A cached result of an older generation is not
+    used. Space released by stubbing or allocated by recalls is not
+    processed by the overlay and is reflected after the TTL at the
+    latest. The overlay serves a single source file system, so the
+    cache does not depend on the path.
+
     The following call back functions have been implemented:
 
     @snippet FuseFS.h fuse callback
@@ -136,6 +148,7 @@ public:
         const unsigned long fsid_l;
         pid_t mainpid;
         std::string srcdir;
+        int readyFd;
         std::mutex mask_mutex;
     };
 
@@ -156,11 +169,26 @@ private:
         off_t offset;
     };
 
+    struct statfs_invalidator
+    {
+        ~statfs_invalidator()
+        {
+            FuseFS::fsGeneration++;
+        }
+    };
+
     std::string mountpt;
     std::thread *thrd;
     int rootFd;
     int ioctlFd;
     static std::mutex mask_mutex;
+    static std::mutex spawn_mutex;
+
+    static std::mutex statfs_mutex;
+    static struct statvfs statfsCache;
+    static unsigned long statfsGeneration;
+    static std::chrono::steady_clock::time_point statfsExpiry;
+    static std::atomic<unsigned long> fsGeneration;
 
     struct
     {
@@ -242,7 +270,8 @@ private:
     //! [fuse callback]
 
     static void execute(std::string sourcedir, std::string mountpt,
-            std::string command);
+            FILE *cmd);
+    bool waitReady(int readyFd);
 
 public:
     static FuseFS::mig_state_attr_t genMigInfoAt(int fd,
@@ -15,6 +15,7 @@
  *
  *******************************************************************************/
 #include <unistd.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <sys/types.h>
 #include <dirent.h>
@@ -30,6 +31,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <memory>
 
 #include "src/common/errors.h"
 #include "src/common/LTFSDMException.h"
@@ -95,6 +98,11 @@ void getUUID(std::string fsName, uuid_t *uuid)
     - The Fuse options are set.
     - The Fuse shared information is set.
 
+    The file descriptor provided with the -r option is the write end of a
+    pipe the backend is waiting on. It is written to within
+    FuseFS::ltfsdm_init to tell the backend that the overlay file system
+    is mounted.
+
  */
 
 /**
@@ -108,7 +116,8 @@ int main(int argc, char **argv)
     std::string mountpt("");
     std::string fsName("");
     struct timespec starttime = { 0, 0 };
-    pid_t mainpid;
+    pid_t mainpid = 0;
+    int readyFd = Const::UNSET;
     uuid_t uuid;
     Message::LogType logType;
     Trace::traceLevel tl;
@@ -123,7 +132,7 @@ int main(int argc, char **argv)
     struct fuse_args fargs;
     std::stringstream options;
 
-    while ((opt = getopt(argc, argv, "m:f:S:N:l:t:p:")) != -1) {
+    while ((opt = getopt(argc, argv, "m:f:S:N:l:t:p:r:")) != -1) {
         switch (opt) {
             case 'm':
                 if (mountpt.compare("") != 0)
@@ -163,12 +172,17 @@ int main(int argc, char **argv)
                     return static_cast<int>(Error::GENERAL_ERROR);
                 mainpid = static_cast<pid_t>(std::stoi(optarg, nullptr));
                 break;
+            case 'r':
+                if (readyFd != Const::UNSET)
+                    return static_cast<int>(Error::GENERAL_ERROR);
+                readyFd = std::stoi(optarg, nullptr);
+                break;
             default:
                 return static_cast<int>(Error::GENERAL_ERROR);
         }
     }
 
-    if (optind != 15) {
+    if (optind != 17) {
         MSG(LTFSDMF0004E);
         return static_cast<int>(Error::GENERAL_ERROR);
     }
@@ -217,8 +231,14 @@ int main(int argc, char **argv)
         be64toh(*(unsigned long *) &uuid[0]),
         be64toh(*(unsigned long *) &uuid[8]),
         mainpid,
-        mountpt + Const::LTFSDM_CACHE_MP
+        mountpt + Const::LTFSDM_CACHE_MP,
+        readyFd
     };
 
+    if (fcntl(readyFd, F_SETFD, FD_CLOEXEC) == -1) {
+        MSG(LTFSDMF0004E);
+        return static_cast<int>(Error::GENERAL_ERROR);
+    }
+
     return fuse_main(fargs.argc, fargs.argv, &ltfsdm_operations, (void * ) &sd);
 }
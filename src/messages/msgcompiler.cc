@@ -26,6 +26,7 @@ typedef struct
 {
     std::string msgname;
     std::string msgtxt;
+    int numargs;
 } message_t;
 
 const std::string IDENTIFIER = "LTFSDM";
@@ -51,6 +52,27 @@ std::string escape(std::string input)
     return result;
 }
 
+/*
+ * Counts the format specifications of a message text line, "%%" is
+ * printed as a single '%' and does not consume an argument.
+ */
+int countArgs(std::string input)
+
+{
+    int count = 0;
+
+    for (std::string::size_type i = 0; i < input.size(); i++) {
+        if (input[i] != '%')
+            continue;
+        if (i + 1 < input.size() && input[i + 1] == '%')
+            i++;
+        else
+            count++;
+    }
+
+    return count;
+}
+
 int main(int argc, char **argv)
 
 {
@@ -104,6 +126,7 @@ int main(int argc, char **argv)
             messages.back().msgtxt += '\n';
             messages.back().msgtxt += "                       ";
             messages.back().msgtxt += "+std::string(" + line + ")";
+            messages.back().numargs += countArgs(line);
             documentation.back().msgtxt += "<BR>";
             documentation.back().msgtxt += escape(line);
         }
@@ -119,8 +142,10 @@ int main(int argc, char **argv)
             first = line.substr(0, line.find(' '));
             second = line.substr(line.find('"'), std::string::npos - 1);
             messages.push_back(
-                    (message_t ) { first, "std::string(" + second + ")" });
-            documentation.push_back((message_t ) { first, escape(second) });
+                    (message_t ) { first, "std::string(" + second + ")",
+                                    countArgs(second) });
+            documentation.push_back(
+                    (message_t ) { first, escape(second), 0 });
         }
     }
 
@@ -164,6 +189,23 @@ int main(int argc, char **argv)
     outfile << "};" << std::endl;
     outfile << std::endl;
 
+    outfile << "const int ltfsdm_msgnum = " << messages.size() << ";"
+            << std::endl;
+    outfile << std::endl;
+
+    // number of arguments for compile time checking of MSG() and INFO()
+    outfile << "constexpr int ltfsdm_msgargs[] = {" << std::endl;
+    for (it = messages.begin(); it != messages.end(); ++it) {
+        if (it + 1 != messages.end())
+            outfile << "    " << "/* " << it->msgname << " */  "
+                    << it->numargs << "," << std::endl;
+        else
+            outfile << "    " << "/* " << it->msgname << " */  "
+                    << it->numargs << std::endl;
+    }
+    outfile << "};" << std::endl;
+    outfile << std::endl;
+
     outfile.close();
 
     for (it = documentation.begin(); it != documentation.end(); ++it) {
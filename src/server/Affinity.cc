@@ -0,0 +1,206 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page thread_affinity Thread Affinity
+
+    # Thread Affinity
+
+    On hosts with more than one NUMA node the data that is transferred
+    between disk and tape should not cross the interconnect between the
+    nodes. Therefore the threads that perform data transfers or stubbing
+    can be bound to a set of CPUs. The CPUs are specified within the
+    configuration file by lines of the following format:
+
+    @verbatim
+    affinity: <key> <cpu list>
+    @endverbatim
+
+    The cpu list has the same format as used by the Linux kernel,
+    e.g. "0-7,16-23". The following keys are available:
+
+    key | threads
+    ---|---
+    stubbing | Server::wqs
+    recall | transparent recall threads created by TransRecall::run
+    drive id | LTFSDMDrive::wqp and the threads executing SelRecall::execRequest and TransRecall::execRequest on that drive
+
+    If no CPUs are configured for a drive the CPUs of the NUMA node the
+    host bus adapter of the drive is attached to are used. This information
+    is taken from sysfs for the device name provided by LTFS LE. If it
+    is not available the threads are not bound.
+
+    No explicit memory policy is set. Since the buffers used for the
+    transfer (e.g. within Migration::transferData) are allocated by the
+    bound threads the Linux default policy already provides memory of the
+    local NUMA node.
+
+ */
+
+bool Affinity::parse(std::string cpuList, cpu_set_t *cpus)
+
+{
+    std::stringstream sslist(cpuList);
+    std::string range;
+    unsigned long first;
+    unsigned long last;
+    size_t pos;
+
+    CPU_ZERO(cpus);
+
+    while (std::getline(sslist, range, ',')) {
+        try {
+            first = std::stoul(range, &pos);
+            last = first;
+            if (pos < range.size()) {
+                if (range[pos] != '-')
+                    return false;
+                range = range.substr(pos + 1);
+                last = std::stoul(range, &pos);
+                if (pos < range.size())
+                    return false;
+            }
+        } catch (const std::exception& e) {
+            return false;
+        }
+
+        if (first > last || last >= CPU_SETSIZE)
+            return false;
+
+        for (unsigned long cpu = first; cpu <= last; cpu++)
+            CPU_SET(cpu, cpus);
+    }
+
+    return CPU_COUNT(cpus) > 0;
+}
+
+std::string Affinity::getDeviceCpus(std::string devName)
+
+{
+    std::string dev = devName.substr(devName.rfind('/') + 1);
+    std::stringstream sspath;
+    std::ifstream nodefile;
+    std::ifstream cpufile;
+    std::string cpuList;
+    char *rpath = NULL;
+    std::string path;
+    int node = Const::UNSET;
+
+    for (std::string cls : { "scsi_generic", "scsi_tape" }) {
+        path = std::string("/sys/class/") + cls + "/" + dev + "/device";
+        if ((rpath = realpath(path.c_str(), NULL)) != NULL)
+            break;
+    }
+
+    if (rpath == NULL) {
+        TRACE(Trace::normal, devName, errno);
+        return "";
+    }
+
+    path = rpath;
+    free(rpath);
+
+    // the numa_node attribute is provided by the PCI device of the HBA
+    while (path.size() > 1) {
+        nodefile.open(path + "/numa_node");
+        if (nodefile.is_open()) {
+            nodefile >> node;
+            break;
+        }
+        path = path.substr(0, path.rfind('/'));
+    }
+
+    if (node < 0) {
+        TRACE(Trace::normal, devName, node);
+        return "";
+    }
+
+    sspath << "/sys/devices/system/node/node" << node << "/cpulist";
+    cpufile.open(sspath.str());
+    if (!cpufile.is_open() || !std::getline(cpufile, cpuList)) {
+        TRACE(Trace::error, sspath.str());
+        return "";
+    }
+
+    TRACE(Trace::always, devName, node, cpuList);
+
+    return cpuList;
+}
+
+std::string Affinity::getCpus(std::string key)
+
+{
+    std::string cpuList = Server::conf.getAffinity(key);
+    cpu_set_t cpus;
+
+    if (cpuList.compare("") == 0)
+        return "";
+
+    if (parse(cpuList, &cpus) == false) {
+        MSG(LTFSDMS0122W, cpuList, key);
+        return "";
+    }
+
+    MSG(LTFSDMS0123I, key, cpuList);
+
+    return cpuList;
+}
+
+std::string Affinity::getDriveCpus(std::string driveId, std::string devName)
+
+{
+    std::string cpuList = getCpus(driveId);
+    cpu_set_t cpus;
+
+    if (cpuList.compare("") != 0)
+        return cpuList;
+
+    cpuList = getDeviceCpus(devName);
+
+    if (cpuList.compare("") == 0 || parse(cpuList, &cpus) == false)
+        return "";
+
+    MSG(LTFSDMS0123I, driveId, cpuList);
+
+    return cpuList;
+}
+
+void Affinity::bindThread(std::string cpuList)
+
+{
+    cpu_set_t cpus;
+    int rc;
+
+    if (cpuList.compare("") == 0 || parse(cpuList, &cpus) == false)
+        return;
+
+    if ((rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus))
+            != 0)
+        TRACE(Trace::error, cpuList, rc);
+}
+
+void Affinity::bindThreadToDrive(std::string driveId)
+
+{
+    std::shared_ptr<LTFSDMDrive> drive;
+
+    if (driveId.compare("") == 0
+            || (drive = inventory->getDrive(driveId)) == nullptr)
+        return;
+
+    bindThread(drive->cpuList);
+}
@@ -0,0 +1,29 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class Affinity
+{
+private:
+    static std::string getDeviceCpus(std::string devName);
+public:
+    static bool parse(std::string cpuList, cpu_set_t *cpus);
+    static std::string getCpus(std::string key);
+    static std::string getDriveCpus(std::string driveId, std::string devName);
+    static void bindThread(std::string cpuList);
+    static void bindThreadToDrive(std::string driveId);
+};
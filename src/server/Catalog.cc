@@ -0,0 +1,381 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page catalog Catalog
+
+    # Catalog
+
+    The location of the data of a migrated file is stored in the
+    attributes of the file (see FsObj::getAttribute). To determine which
+    files are stored on a cartridge without traversing all managed file
+    systems a catalog is maintained in addition. Different to the
+    SQLite tables that are used for queuing (see @ref sqlite) the
+    catalog is stored persistently in Const::CATALOG_FILE. It uses its
+    own connection CatalogDB in WAL mode with synchronous=NORMAL (see
+    DataBase::open(std::string)) such that catalog updates neither
+    synchronize the queuing tables nor wait for them.
+
+    ## TAPE_FILES
+
+    column | data type | details
+    ---|---|---
+    TAPE_ID | CHAR(9) | id of the cartridge
+    START_BLOCK | BIGINT | starting block of the data on tape
+    FS_ID_H | BIGINT | higher 64 bit part of the 128 bit file system id
+    FS_ID_L | BIGINT | lower 64 bit part of the 128 bit file system id
+    I_GEN | INT | inode generation number
+    I_NUM | BIGINT | inode number
+    FILE_NAME | CHAR(4096) | file name at the time of the migration
+    FILE_SIZE | BIGINT | file size
+    FILE_STATE | INT | file state: see FsObj::file_state
+
+    The primary key is the combination of TAPE_ID and START_BLOCK such
+    that the files of a cartridge can be listed in the order of their
+    position on tape by an index range scan.
+
+    - Migration::transferData adds an entry after the data of a file
+      has been written to tape.
+    - Migration::changeFileState updates the state after a file has been
+      stubbed.
+    - Catalog::add and Catalog::setState do not write to the catalog
+      directly. The updates are queued and written by Catalog::flush
+      within a single transaction. This happens if
+      Const::CATALOG_BATCH_SIZE updates are pending, at the end of each
+      stubbing batch (Migration::changeFileStates), after all data of a
+      migration job has been transferred and when the server stops.
+      Catalog::flush is also called before the entries are read or
+      removed in a different way.
+    - TapeHandler removes all entries of a cartridge after it has been
+      formatted.
+    - Catalog::TapeFiles iterates over the entries of a cartridge in the
+      order of their start blocks. It is used by the
+      [ltfsdm info catalog](@ref ltfsdm_info_catalog) command and can be
+      used to order recalls by their position on tape.
+    - Catalog::rebuild replaces the entries of a cartridge by the files
+      found in its LTFS index (see @ref index_parser). It is triggered
+      by the [ltfsdm rebuild](@ref ltfsdm_rebuild) command. Since the
+      state of the files on disk is not known from the index the
+      entries are added as migrated. The rebuild uses a connection of
+      its own. The files of the index are first collected in the
+      temporary table REBUILD_FILES. The existing entries of the
+      cartridge are replaced only after the whole index has been
+      parsed, within the same transaction. If the index is malformed
+      the transaction is rolled back and the existing entries are
+      kept. Since the temporary table is not part of the catalog file,
+      other connections are not blocked while the index is parsed.
+    - SelRecall::addJob and TransRecall::addJob use Catalog::getStartBlock
+      if the start block is not available from the file attributes.
+      Updates that are still queued are not visible to it.
+
+    Catalog::trans_mutex serializes the transactions on CatalogDB.
+
+    If the catalog cannot be opened the server continues without it.
+
+ */
+
+bool Catalog::available = false;
+std::mutex Catalog::mtx;
+std::vector<std::string> Catalog::pending;
+std::mutex Catalog::trans_mutex;
+
+void Catalog::open()
+
+{
+    SQLStatement stmt(CatalogDB);
+
+    if (mkdir(Const::CATALOG_DIR.c_str(), 0700) == -1 && errno != EEXIST) {
+        TRACE(Trace::error, errno);
+        MSG(LTFSDMS0125W, Const::CATALOG_FILE);
+        return;
+    }
+
+    try {
+        CatalogDB.open(Const::CATALOG_FILE);
+
+        stmt(Catalog::CREATE_TAPE_FILES);
+        stmt.doall();
+
+        stmt(Catalog::CREATE_TAPE_FILES_UID);
+        stmt.doall();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0125W, Const::CATALOG_FILE);
+        return;
+    }
+
+    available = true;
+}
+
+void Catalog::queue(std::string statement)
+
+{
+    bool full;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending.push_back(statement);
+        full = pending.size() >= Const::CATALOG_BATCH_SIZE;
+    }
+
+    if (full)
+        flush();
+}
+
+void Catalog::add(std::string tapeId, long startBlock, fuid_t fuid,
+        std::string fileName, unsigned long size)
+
+{
+    SQLStatement stmt;
+
+    if (!available)
+        return;
+
+    try {
+        stmt(Catalog::ADD_FILE) << tapeId << startBlock << fuid.fsid_h
+                << fuid.fsid_l << fuid.igen << fuid.inum << fileName << size
+                << FsObj::PREMIGRATED;
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0126E, fileName, tapeId);
+        return;
+    }
+
+    TRACE(Trace::full, stmt.str());
+
+    queue(stmt.str());
+}
+
+void Catalog::setState(fuid_t fuid, FsObj::file_state state)
+
+{
+    SQLStatement stmt;
+
+    if (!available)
+        return;
+
+    try {
+        stmt(Catalog::SET_FILE_STATE) << state << fuid.fsid_h << fuid.fsid_l
+                << fuid.igen << fuid.inum;
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what(), fuid.inum);
+        return;
+    }
+
+    TRACE(Trace::full, stmt.str());
+
+    queue(stmt.str());
+}
+
+void Catalog::flush()
+
+{
+    std::lock_guard<std::mutex> trans_lock(trans_mutex);
+    SQLStatement stmt(CatalogDB);
+    std::vector<std::string> updates;
+    int failed = 0;
+
+    if (!available)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        updates.swap(pending);
+    }
+
+    if (updates.size() == 0)
+        return;
+
+    TRACE(Trace::normal, updates.size());
+
+    try {
+        stmt(DataBase::BEGIN_TRANSACTION);
+        stmt.doall();
+
+        for (std::string update : updates) {
+            try {
+                stmt(update);
+                stmt.doall();
+            } catch (const std::exception& e) {
+                TRACE(Trace::error, e.what(), update);
+                failed++;
+            }
+        }
+
+        stmt(DataBase::COMMIT_TRANSACTION);
+        stmt.doall();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        failed = updates.size();
+        try {
+            stmt(DataBase::ROLLBACK_TRANSACTION);
+            stmt.doall();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+        }
+    }
+
+    if (failed > 0)
+        MSG(LTFSDMS0134E, failed, updates.size());
+}
+
+void Catalog::removeTape(std::string tapeId)
+
+{
+    SQLStatement stmt(CatalogDB);
+
+    if (!available)
+        return;
+
+    flush();
+
+    std::lock_guard<std::mutex> lock(trans_mutex);
+
+    stmt(Catalog::REMOVE_TAPE) << tapeId;
+
+    TRACE(Trace::normal, stmt.str());
+
+    try {
+        stmt.doall();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what(), tapeId);
+    }
+}
+
+long Catalog::getStartBlock(std::string tapeId, fuid_t fuid)
+
+{
+    SQLStatement stmt(CatalogDB);
+    long startBlock = Const::UNSET;
+
+    if (!available)
+        return Const::UNSET;
+
+    stmt(Catalog::GET_START_BLOCK) << tapeId << fuid.fsid_h << fuid.fsid_l
+            << fuid.igen << fuid.inum;
+
+    TRACE(Trace::full, stmt.str());
+
+    try {
+        stmt.prepare();
+        if (!stmt.step(&startBlock))
+            startBlock = Const::UNSET;
+        stmt.finalize();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what(), fuid.inum);
+        return Const::UNSET;
+    }
+
+    return startBlock;
+}
+
+Catalog::TapeFiles::TapeFiles(std::string tapeId) :
+        stmt(CatalogDB)
+
+{
+    if (!Catalog::isAvailable())
+        THROW(Error::GENERAL_ERROR);
+
+    Catalog::flush();
+
+    stmt(Catalog::SELECT_TAPE) << tapeId;
+
+    TRACE(Trace::normal, stmt.str());
+
+    stmt.prepare();
+}
+
+Catalog::TapeFiles::~TapeFiles()
+
+{
+    try {
+        stmt.finalize();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+    }
+}
+
+bool Catalog::TapeFiles::next(Catalog::entry_t *entry)
+
+{
+    return stmt.step(&entry->startBlock, &entry->size, &entry->state,
+            &entry->fileName, &entry->fuid.fsid_h, &entry->fuid.fsid_l,
+            &entry->fuid.igen, &entry->fuid.inum);
+}
+
+long Catalog::rebuild(std::string tapeId, std::string indexFile)
+
+{
+    DataBase rebuildDB;
+    SQLStatement stmt(rebuildDB);
+    IndexParser::file_t file;
+    long numFiles = 0;
+    std::chrono::time_point<std::chrono::steady_clock> start =
+            std::chrono::steady_clock::now();
+
+    if (!available)
+        THROW(Error::GENERAL_ERROR);
+
+    IndexParser parser(indexFile);
+
+    flush();
+
+    rebuildDB.open(Const::CATALOG_FILE);
+
+    stmt(Catalog::CREATE_REBUILD_FILES);
+    stmt.doall();
+
+    stmt(DataBase::BEGIN_TRANSACTION);
+    stmt.doall();
+
+    try {
+        while (parser.next(&file)) {
+            stmt(Catalog::ADD_REBUILD_FILE) << tapeId << file.startBlock
+                    << file.fuid.fsid_h << file.fuid.fsid_l << file.fuid.igen
+                    << file.fuid.inum
+                    << (file.fileName.size() > 0 ? file.fileName : file.name)
+                    << file.size << FsObj::MIGRATED;
+            stmt.doall();
+
+            numFiles++;
+        }
+
+        stmt(Catalog::REMOVE_TAPE) << tapeId;
+        stmt.doall();
+
+        stmt(Catalog::COPY_REBUILD_FILES);
+        stmt.doall();
+
+        stmt(DataBase::COMMIT_TRANSACTION);
+        stmt.doall();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what(), tapeId, numFiles);
+        try {
+            stmt(DataBase::ROLLBACK_TRANSACTION);
+            stmt.doall();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+        }
+        throw;
+    }
+
+    MSG(LTFSDMS0129I, tapeId, indexFile, numFiles,
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+
+    return numFiles;
+}
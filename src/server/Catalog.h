@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class Catalog
+{
+private:
+    static bool available;
+    static std::mutex mtx;
+    static std::vector<std::string> pending;
+    static const std::string CREATE_TAPE_FILES;
+    static const std::string CREATE_TAPE_FILES_UID;
+    static const std::string ADD_FILE;
+    static const std::string SET_FILE_STATE;
+    static const std::string REMOVE_TAPE;
+    static const std::string GET_START_BLOCK;
+    static const std::string SELECT_TAPE;
+    static const std::string CREATE_REBUILD_FILES;
+    static const std::string ADD_REBUILD_FILE;
+    static const std::string COPY_REBUILD_FILES;
+    static void queue(std::string statement);
+public:
+    struct entry_t
+    {
+        long startBlock;
+        unsigned long size;
+        FsObj::file_state state;
+        std::string fileName;
+        fuid_t fuid;
+    };
+    class TapeFiles
+    {
+    private:
+        SQLStatement stmt;
+    public:
+        TapeFiles(std::string tapeId);
+        ~TapeFiles();
+        bool next(Catalog::entry_t *entry);
+    };
+    static std::mutex trans_mutex;
+    static void open();
+    static bool isAvailable()
+    {
+        return available;
+    }
+    static void add(std::string tapeId, long startBlock, fuid_t fuid,
+            std::string fileName, unsigned long size);
+    static void setState(fuid_t fuid, FsObj::file_state state);
+    static void flush();
+    static void removeTape(std::string tapeId);
+    static long getStartBlock(std::string tapeId, fuid_t fuid);
+    static long rebuild(std::string tapeId, std::string indexFile);
+};
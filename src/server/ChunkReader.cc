@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page chunk_reader Chunk Reader
+
+    # ChunkReader
+
+    Migration::transferData copies the data of a file to tape by a
+    sequence of reads and writes. For large files a single reader can be
+    slower than the tape drive. Therefore files of at least
+    Const::PARALLEL_READ_MIN_SIZE bytes are read by Const::PARALLEL_READERS
+    threads in parallel. The writes to tape still are sequential.
+
+    - The file is divided into chunks of Const::PARALLEL_READ_CHUNK_SIZE
+      bytes. Reader n reads the chunks n, n + Const::PARALLEL_READERS,
+      n + 2 * Const::PARALLEL_READERS, ...
+    - There are two buffers (slots) per reader. Chunk k is read into
+      slot k modulo the number of slots. A reader waits until the
+      chunk previously stored in that slot has been written to tape.
+    - ChunkReader::next provides the chunks in the order of their
+      offsets. It waits until the next chunk has been read completely.
+      The slot of a chunk is released by the following call of
+      ChunkReader::next.
+
+    For smaller files no threads are started and ChunkReader::next reads
+    the data itself with a buffer of Const::READ_BUFFER_SIZE bytes.
+
+    Each chunk is written to tape by a single write call. To avoid partial
+    block writes on tape the chunk size is rounded up to a multiple of the
+    block size of the LTFS file system (see LTFSDMInventory::getBlockSize).
+    Since a chunk is always read completely only the last chunk of a file
+    can be shorter.
+
+ */
+
+ChunkReader::ChunkReader(FsObj& source_, long fileSize_, long blockSize) :
+        source(source_), fileSize(fileSize_), chunkSize(
+                align(fileSize_ < Const::PARALLEL_READ_MIN_SIZE ?
+                        Const::READ_BUFFER_SIZE :
+                        Const::PARALLEL_READ_CHUNK_SIZE, blockSize)), numChunks(
+                (fileSize_ + chunkSize - 1) / chunkSize), numReaders(
+                fileSize_ < Const::PARALLEL_READ_MIN_SIZE ?
+                        0 : Const::PARALLEL_READERS), consumed(0), released(0), abort(
+                false)
+
+{
+    slots.resize(numReaders > 0 ? 2 * numReaders : 1);
+
+    for (slot_t& slot : slots) {
+        slot.chunk = Const::UNSET;
+        slot.size = 0;
+        slot.error = 0;
+        slot.buffer = std::unique_ptr<char[]>(new char[chunkSize]);
+    }
+
+    for (int i = 0; i < numReaders; i++)
+        readers.push_back(std::thread(&ChunkReader::readChunks, this, i));
+}
+
+ChunkReader::~ChunkReader()
+
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        abort = true;
+        cond.notify_all();
+    }
+
+    for (std::thread& reader : readers)
+        reader.join();
+}
+
+long ChunkReader::align(long size, long blockSize)
+
+{
+    if (blockSize <= 0)
+        return size;
+
+    return ((size + blockSize - 1) / blockSize) * blockSize;
+}
+
+long ChunkReader::readChunk(long chunk, char *buffer, int *error)
+
+{
+    long offset = chunk * chunkSize;
+    long size = std::min(chunkSize, fileSize - offset);
+    long rsize;
+    long done = 0;
+
+    try {
+        while (done < size) {
+            rsize = source.read(offset + done, size - done, buffer + done);
+            if (rsize <= 0) {
+                *error = (rsize == 0 ? EIO : errno);
+                TRACE(Trace::error, offset + done, rsize, *error);
+                return -1;
+            }
+            done += rsize;
+        }
+    } catch (const std::exception& e) {
+        *error = errno;
+        TRACE(Trace::error, e.what(), offset);
+        return -1;
+    }
+
+    return done;
+}
+
+void ChunkReader::readChunks(int readerNum)
+
+{
+    long numSlots = slots.size();
+    long size;
+    int error;
+
+    for (long chunk = readerNum; chunk < numChunks; chunk += numReaders) {
+        slot_t& slot = slots[chunk % numSlots];
+
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cond.wait(lock,
+                    [this, chunk, numSlots] {return abort || chunk < released + numSlots;});
+            if (abort)
+                return;
+        }
+
+        error = 0;
+        size = readChunk(chunk, slot.buffer.get(), &error);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        slot.size = size;
+        slot.error = error;
+        slot.chunk = chunk;
+        cond.notify_all();
+
+        if (size == -1)
+            return;
+    }
+}
+
+/**
+ * Provides the next chunk of the file.
+ *
+ * @param buffer set to the buffer containing the data
+ * @return size of the data, 0 at the end of the file, -1 in case of an
+ *         error with errno set accordingly
+ */
+long ChunkReader::next(char **buffer)
+
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    slot_t& slot = slots[consumed % slots.size()];
+
+    // the slot of the previous chunk can be reused
+    if (released < consumed) {
+        released = consumed;
+        cond.notify_all();
+    }
+
+    if (consumed == numChunks)
+        return 0;
+
+    if (numReaders == 0) {
+        lock.unlock();
+        slot.size = readChunk(consumed, slot.buffer.get(), &slot.error);
+        lock.lock();
+    } else {
+        cond.wait(lock, [this, &slot] {return slot.chunk == consumed;});
+    }
+
+    if (slot.size == -1) {
+        errno = slot.error;
+        return -1;
+    }
+
+    *buffer = slot.buffer.get();
+    consumed++;
+
+    return slot.size;
+}
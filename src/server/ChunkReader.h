@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class ChunkReader
+{
+private:
+    struct slot_t
+    {
+        long chunk;
+        long size;
+        int error;
+        std::unique_ptr<char[]> buffer;
+    };
+    FsObj& source;
+    const long fileSize;
+    const long chunkSize;
+    const long numChunks;
+    const int numReaders;
+    std::vector<slot_t> slots;
+    std::vector<std::thread> readers;
+    std::mutex mtx;
+    std::condition_variable cond;
+    long consumed;
+    long released;
+    bool abort;
+
+    static long align(long size, long blockSize);
+    long readChunk(long chunk, char *buffer, int *error);
+    void readChunks(int readerNum);
+public:
+    ChunkReader(FsObj& source_, long fileSize_, long blockSize);
+    ~ChunkReader();
+    long next(char **buffer);
+};
@@ -17,8 +17,8 @@
 #include "ServerIncludes.h"
 
 DataBase DB;
-
-std::mutex DataBase::trans_mutex;
+// defined after DB to be closed before SQLite is shut down
+DataBase CatalogDB;
 
 DataBase::~DataBase()
 
@@ -26,7 +26,8 @@ DataBase::~DataBase()
     if (dbNeedsClosed)
         sqlite3_close(db);
 
-    sqlite3_shutdown();
+    if (dbNeedsShutdown)
+        sqlite3_shutdown();
 }
 
 void DataBase::cleanup()
@@ -85,6 +86,8 @@ void DataBase::open(bool dbUseMemory)
         THROW(Error::GENERAL_ERROR, rc);
     }
 
+    dbNeedsShutdown = true;
+
     rc = sqlite3_open_v2(uri.c_str(), &db, SQLITE_OPEN_READWRITE |
     SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX |
     SQLITE_OPEN_SHAREDCACHE | SQLITE_OPEN_EXCLUSIVE, NULL);
@@ -109,6 +112,48 @@ void DataBase::open(bool dbUseMemory)
     NULL, NULL);
 }
 
+/**
+ * Opens an additional connection to a persistent database file. Different
+ * to the connection opened by DataBase::open(bool) it does not share the
+ * cache and operates in WAL mode. Commits therefore do not need to wait
+ * for all data to be synchronized to disk, and readers on other
+ * connections are not blocked by a writer. SQLite already needs to be
+ * initialized by DataBase::open(bool).
+ */
+void DataBase::open(std::string fileName)
+
+{
+    SQLStatement stmt(*this);
+    int rc;
+
+    rc = sqlite3_open_v2(fileName.c_str(), &db, SQLITE_OPEN_READWRITE |
+    SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, NULL);
+
+    if (rc != SQLITE_OK) {
+        TRACE(Trace::error, rc, fileName);
+        sqlite3_close(db);
+        db = NULL;
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, fileName, rc);
+    }
+
+    dbNeedsClosed = true;
+
+    if ((rc = sqlite3_extended_result_codes(db, 1)) != SQLITE_OK
+            || (rc = sqlite3_busy_timeout(db, Const::DB_BUSY_TIMEOUT))
+                    != SQLITE_OK) {
+        TRACE(Trace::error, rc);
+        errno = rc;
+        THROW(Error::GENERAL_ERROR, rc);
+    }
+
+    stmt(DataBase::SET_WAL_MODE);
+    stmt.doall();
+
+    stmt(DataBase::SET_SYNCHRONOUS_NORMAL);
+    stmt.doall();
+}
+
 void DataBase::createTables()
 
 {
@@ -187,7 +232,8 @@ void SQLStatement::prepare()
 {
     int rc;
 
-    rc = sqlite3_prepare_v2(DB.getDB(), fmt.str().c_str(), -1, &stmt, NULL);
+    rc = sqlite3_prepare_v2(database->getDB(), fmt.str().c_str(), -1, &stmt,
+            NULL);
 
     if (rc != SQLITE_OK) {
         TRACE(Trace::error, fmt.str(), rc);
@@ -21,9 +21,12 @@ class DataBase
 private:
     sqlite3 *db;
     bool dbNeedsClosed;
+    bool dbNeedsShutdown;
     static void fits(sqlite3_context *ctx, int argc, sqlite3_value **argv);
     static const std::string CREATE_JOB_QUEUE;
     static const std::string CREATE_REQUEST_QUEUE;
+    static const std::string SET_WAL_MODE;
+    static const std::string SET_SYNCHRONOUS_NORMAL;
 public:
     enum operation
     {
@@ -43,14 +46,17 @@ public:
         REQ_INPROGRESS, /**@< 1 */
         REQ_COMPLETED /**@< 2 */
     };
-    static std::mutex trans_mutex;
+    static const std::string BEGIN_TRANSACTION;
+    static const std::string COMMIT_TRANSACTION;
+    static const std::string ROLLBACK_TRANSACTION;
     DataBase() :
-            db(NULL), dbNeedsClosed(false)
+            db(NULL), dbNeedsClosed(false), dbNeedsShutdown(false)
     {
     }
     ~DataBase();
     void cleanup();
     void open(bool dbUseMemory);
+    void open(std::string fileName);
     void createTables();
     int lastUpdates();
     sqlite3 *getDB()
@@ -62,10 +68,12 @@ public:
 };
 
 extern DataBase DB;
+extern DataBase CatalogDB;
 
 class SQLStatement
 {
 private:
+    DataBase *database;
     std::string fmtstr;
     sqlite3_stmt *stmt;
     boost::format fmt;
@@ -103,14 +111,19 @@ private:
 
 public:
     SQLStatement() :
-            fmtstr(""), stmt(nullptr), fmt(""), stmt_rc(0)
+            database(&DB), fmtstr(""), stmt(nullptr), fmt(""), stmt_rc(0)
     {
     }
-    SQLStatement(std::string _fmtstr) :
-            fmtstr(_fmtstr), stmt(nullptr), fmt(boost::format(fmtstr)), stmt_rc(
+    SQLStatement(DataBase& _database) :
+            database(&_database), fmtstr(""), stmt(nullptr), fmt(""), stmt_rc(
                     0)
     {
     }
+    SQLStatement(std::string _fmtstr) :
+            database(&DB), fmtstr(_fmtstr), stmt(nullptr), fmt(
+                    boost::format(fmtstr)), stmt_rc(0)
+    {
+    }
     SQLStatement& operator()(std::string _fmtstr);
     ~SQLStatement()
     {
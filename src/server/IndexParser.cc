@@ -0,0 +1,450 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page index_parser LTFS Index Parser
+
+    # IndexParser
+
+    The start block of the data of a migrated file is stored in the
+    attributes of the file and in the @ref catalog. Both are set by
+    Migration::transferData that reads it by Server::getStartBlock from
+    the file on the mounted LTFS file system. If this information gets
+    lost (e.g. after a disaster or for files that have been migrated by
+    an earlier version) it can be recovered from the LTFS index of the
+    cartridge instead of opening each file on tape separately. An index
+    can be captured with <tt>ltfsck --capture-index</tt>.
+
+    The index of a cartridge holding millions of files is too large to
+    be loaded completely. Therefore the IndexParser does not build a
+    document tree. The file is mapped into memory and scanned once from
+    the beginning to the end:
+
+    - Only a stack of the open elements and of the names of the
+      enclosing directories is maintained. The text of an element
+      is only decoded if it is of interest.
+    - The mapping is advised to be read sequentially and the pages that
+      already have been processed are released every
+      Const::INDEX_RELEASE_SIZE bytes such that the memory usage does
+      not grow with the size of the index.
+    - IndexParser::next returns the next file that has been stored by
+      the backend, i.e. a file within the Const::LTFSDM_DATA_DIR
+      directory named like Server::getTapeName creates it. The file uid
+      is derived from the name, the original file name from the
+      Const::LTFS_ATTR extended attribute. The start block is the one
+      of the extent at file offset 0.
+
+    The parser is used by Catalog::rebuild which is triggered by the
+    [ltfsdm rebuild](@ref ltfsdm_rebuild) command.
+
+ */
+
+IndexParser::IndexParser(std::string indexFile_) :
+        indexFile(indexFile_), fd(Const::UNSET), addr(NULL), size(0), pos(
+                NULL), released(NULL)
+
+{
+    struct stat statbuf;
+    void *mapped;
+
+    if ((fd = open(indexFile.c_str(), O_RDONLY | O_CLOEXEC)) == -1) {
+        MSG(LTFSDMS0127E, indexFile, errno);
+        THROW(Error::GENERAL_ERROR, errno, indexFile);
+    }
+
+    if (fstat(fd, &statbuf) == -1 || statbuf.st_size == 0) {
+        MSG(LTFSDMS0127E, indexFile, errno);
+        close(fd);
+        THROW(Error::GENERAL_ERROR, errno, indexFile);
+    }
+
+    size = statbuf.st_size;
+
+    if ((mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0))
+            == MAP_FAILED) {
+        MSG(LTFSDMS0127E, indexFile, errno);
+        close(fd);
+        THROW(Error::GENERAL_ERROR, errno, indexFile);
+    }
+
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    addr = (const char *) mapped;
+    pos = addr;
+    released = addr;
+}
+
+IndexParser::~IndexParser()
+
+{
+    munmap((void *) addr, size);
+    close(fd);
+}
+
+IndexParser::tag_t IndexParser::getTag(const char *name, unsigned long length)
+
+{
+    static const struct
+    {
+        const char *name;
+        unsigned long length;
+        IndexParser::tag_t tag;
+    } tags[] = { { "directory", 9, IndexParser::DIRECTORY }, { "file", 4,
+            IndexParser::FILE }, { "name", 4, IndexParser::NAME }, { "length",
+            6, IndexParser::LENGTH }, { "xattr", 5, IndexParser::XATTR }, {
+            "key", 3, IndexParser::KEY }, { "value", 5, IndexParser::VALUE }, {
+            "extent", 6, IndexParser::EXTENT }, { "partition", 9,
+            IndexParser::PARTITION }, { "startblock", 10,
+            IndexParser::STARTBLOCK }, { "byteoffset", 10,
+            IndexParser::BYTEOFFSET }, { "bytecount", 9,
+            IndexParser::BYTECOUNT }, { "fileoffset", 10,
+            IndexParser::FILEOFFSET } };
+
+    // called for each tag, avoid any allocation
+    for (unsigned long i = 0; i < sizeof(tags) / sizeof(tags[0]); i++)
+        if (tags[i].length == length
+                && memcmp(tags[i].name, name, length) == 0)
+            return tags[i].tag;
+
+    return IndexParser::OTHER;
+}
+
+std::string IndexParser::decode(const char *start, const char *end,
+        bool percentEncoded)
+
+{
+    std::string value;
+    const char *semicolon;
+    std::string entity;
+    unsigned long code;
+
+    value.reserve(end - start);
+
+    while (start < end) {
+        if (*start == '&'
+                && (semicolon = (const char *) memchr(start, ';', end - start))
+                        != NULL) {
+            entity = std::string(start + 1, semicolon - start - 1);
+            if (entity.compare("amp") == 0)
+                value += '&';
+            else if (entity.compare("lt") == 0)
+                value += '<';
+            else if (entity.compare("gt") == 0)
+                value += '>';
+            else if (entity.compare("quot") == 0)
+                value += '"';
+            else if (entity.compare("apos") == 0)
+                value += '\'';
+            else if (entity.size() > 1 && entity[0] == '#') {
+                if (entity[1] == 'x')
+                    code = strtoul(entity.c_str() + 2, NULL, 16);
+                else
+                    code = strtoul(entity.c_str() + 1, NULL, 10);
+                if (code < 0x80) {
+                    value += (char) code;
+                } else if (code < 0x800) {
+                    value += (char) (0xc0 | (code >> 6));
+                    value += (char) (0x80 | (code & 0x3f));
+                } else if (code < 0x10000) {
+                    value += (char) (0xe0 | (code >> 12));
+                    value += (char) (0x80 | ((code >> 6) & 0x3f));
+                    value += (char) (0x80 | (code & 0x3f));
+                } else {
+                    value += (char) (0xf0 | (code >> 18));
+                    value += (char) (0x80 | ((code >> 12) & 0x3f));
+                    value += (char) (0x80 | ((code >> 6) & 0x3f));
+                    value += (char) (0x80 | (code & 0x3f));
+                }
+            } else {
+                value += std::string(start, semicolon - start + 1);
+            }
+            start = semicolon + 1;
+        } else if (percentEncoded && *start == '%' && end - start > 2
+                && isxdigit(start[1]) && isxdigit(start[2])) {
+            value += (char) strtoul(std::string(start + 1, 2).c_str(), NULL,
+                    16);
+            start += 3;
+        } else {
+            value += *start;
+            start++;
+        }
+    }
+
+    return value;
+}
+
+bool IndexParser::parseName(std::string name, fuid_t *fuid)
+
+{
+    std::string prefix = Const::LTFS_NAME + ".";
+    const char *str;
+    char *end;
+
+    if (name.compare(0, prefix.size(), prefix) != 0)
+        return false;
+
+    str = name.c_str() + prefix.size();
+
+    fuid->fsid_h = strtoul(str, &end, 10);
+    if (end == str || *end != '.')
+        return false;
+    str = end + 1;
+
+    fuid->fsid_l = strtoul(str, &end, 10);
+    if (end == str || *end != '.')
+        return false;
+    str = end + 1;
+
+    fuid->igen = strtoul(str, &end, 10);
+    if (end == str || *end != '.')
+        return false;
+    str = end + 1;
+
+    fuid->inum = strtoul(str, &end, 10);
+    if (end == str || *end != 0)
+        return false;
+
+    return true;
+}
+
+void IndexParser::release()
+
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    const char *until = addr + ((pos - addr) / pageSize) * pageSize;
+
+    if (until <= released)
+        return;
+
+    // the pages are read again from the file if they are needed later
+    madvise((void *) released, until - released, MADV_DONTNEED);
+    released = until;
+}
+
+void IndexParser::skip(const char *delim)
+
+{
+    const char *end = addr + size;
+    unsigned long length = strlen(delim);
+
+    while (pos + length <= end) {
+        if (memcmp(pos, delim, length) == 0) {
+            pos += length;
+            return;
+        }
+        pos++;
+    }
+
+    MSG(LTFSDMS0128E, indexFile, size);
+    THROW(Error::GENERAL_ERROR, indexFile);
+}
+
+void IndexParser::setValue(tag_t tag, tag_t parent, std::string value)
+
+{
+    // LTFS stores the attributes of the user namespace without prefix
+    static const std::string attrName = Const::LTFS_ATTR.substr(
+            Const::LTFS_ATTR.find('.') + 1);
+
+    switch (tag) {
+        case IndexParser::NAME:
+            if (parent == IndexParser::DIRECTORY)
+                directories.back() = value;
+            else if (parent == IndexParser::FILE)
+                file.name = value;
+            break;
+        case IndexParser::LENGTH:
+            if (parent == IndexParser::FILE)
+                file.size = strtoul(value.c_str(), NULL, 10);
+            break;
+        case IndexParser::KEY:
+            if (parent == IndexParser::XATTR)
+                key = value;
+            break;
+        case IndexParser::VALUE:
+            if (parent == IndexParser::XATTR
+                    && (key.compare(Const::LTFS_ATTR) == 0
+                            || key.compare(attrName) == 0))
+                file.fileName = value;
+            break;
+        case IndexParser::PARTITION:
+            if (parent == IndexParser::EXTENT && value.size() > 0)
+                extent.partition = value[0];
+            break;
+        case IndexParser::STARTBLOCK:
+            if (parent == IndexParser::EXTENT)
+                extent.startBlock = strtol(value.c_str(), NULL, 10);
+            break;
+        case IndexParser::BYTEOFFSET:
+            if (parent == IndexParser::EXTENT)
+                extent.byteOffset = strtoul(value.c_str(), NULL, 10);
+            break;
+        case IndexParser::BYTECOUNT:
+            if (parent == IndexParser::EXTENT)
+                extent.byteCount = strtoul(value.c_str(), NULL, 10);
+            break;
+        case IndexParser::FILEOFFSET:
+            if (parent == IndexParser::EXTENT)
+                extent.fileOffset = strtoul(value.c_str(), NULL, 10);
+            break;
+        default:
+            break;
+    }
+}
+
+bool IndexParser::closeElement(const char *textEnd)
+
+{
+    element_t element = elements.back();
+    tag_t parent;
+
+    elements.pop_back();
+    parent = elements.empty() ? IndexParser::OTHER : elements.back().tag;
+
+    switch (element.tag) {
+        case IndexParser::OTHER:
+            return false;
+        case IndexParser::DIRECTORY:
+            directories.pop_back();
+            return false;
+        case IndexParser::EXTENT:
+            file.extents.push_back(extent);
+            return false;
+        case IndexParser::FILE:
+            if (directories.empty()
+                    || directories.back().compare(Const::LTFSDM_DATA_DIR) != 0
+                    || !parseName(file.name, &file.fuid))
+                return false;
+            for (extent_t ext : file.extents) {
+                if (ext.fileOffset == 0) {
+                    file.startBlock = ext.startBlock;
+                    break;
+                }
+            }
+            return true;
+        default:
+            setValue(element.tag, parent,
+                    decode(element.text, textEnd, element.percentEncoded));
+            return false;
+    }
+}
+
+bool IndexParser::next(file_t *entry)
+
+{
+    const char *end = addr + size;
+    const char *nameEnd;
+    const char *tagEnd;
+    const char *textEnd;
+    element_t element;
+    bool closing;
+
+    while (pos < end) {
+        if (pos - released > (long) Const::INDEX_RELEASE_SIZE)
+            release();
+
+        if ((pos = (const char *) memchr(pos, '<', end - pos)) == NULL) {
+            pos = end;
+            break;
+        }
+
+        textEnd = pos;
+
+        if (++pos == end)
+            break;
+
+        if (*pos == '?') {
+            skip("?>");
+            continue;
+        } else if (end - pos >= 3 && memcmp(pos, "!--", 3) == 0) {
+            skip("-->");
+            continue;
+        } else if (*pos == '!') {
+            skip(">");
+            continue;
+        }
+
+        if ((tagEnd = (const char *) memchr(pos, '>', end - pos)) == NULL)
+            break;
+
+        if (*pos == '/') {
+            nameEnd = tagEnd;
+            while (nameEnd > pos + 1 && isspace(*(nameEnd - 1)))
+                nameEnd--;
+            if (elements.empty()
+                    || elements.back().tag != getTag(pos + 1, nameEnd - pos - 1)) {
+                MSG(LTFSDMS0128E, indexFile, textEnd - addr);
+                THROW(Error::GENERAL_ERROR, indexFile);
+            }
+            closing = true;
+        } else {
+            nameEnd = pos;
+            while (nameEnd < tagEnd && !isspace(*nameEnd) && *nameEnd != '/')
+                nameEnd++;
+
+            element.tag = getTag(pos, nameEnd - pos);
+            element.percentEncoded = (element.tag == IndexParser::NAME
+                    || element.tag == IndexParser::VALUE)
+                    && memmem(nameEnd, tagEnd - nameEnd, "percentencoded=\"true\"",
+                            21) != NULL;
+            element.text = tagEnd + 1;
+            elements.push_back(element);
+
+            switch (element.tag) {
+                case IndexParser::DIRECTORY:
+                    directories.push_back("");
+                    break;
+                case IndexParser::FILE:
+                    file.name.clear();
+                    file.fileName.clear();
+                    file.size = 0;
+                    file.startBlock = Const::UNSET;
+                    file.extents.clear();
+                    break;
+                case IndexParser::XATTR:
+                    key.clear();
+                    break;
+                case IndexParser::EXTENT:
+                    memset(&extent, 0, sizeof(extent));
+                    extent.startBlock = Const::UNSET;
+                    break;
+                default:
+                    break;
+            }
+
+            // an element without content has an empty text
+            if ((closing = *(tagEnd - 1) == '/'))
+                textEnd = element.text;
+        }
+
+        pos = tagEnd + 1;
+
+        if (closing && closeElement(textEnd)) {
+            std::swap(*entry, file);
+            return true;
+        }
+    }
+
+    if (!elements.empty()) {
+        MSG(LTFSDMS0128E, indexFile, size);
+        THROW(Error::GENERAL_ERROR, indexFile);
+    }
+
+    release();
+
+    return false;
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class IndexParser
+{
+public:
+    struct extent_t
+    {
+        char partition;
+        long startBlock;
+        unsigned long byteOffset;
+        unsigned long byteCount;
+        unsigned long fileOffset;
+    };
+    struct file_t
+    {
+        fuid_t fuid;
+        std::string name;
+        std::string fileName;
+        unsigned long size;
+        long startBlock;
+        std::vector<extent_t> extents;
+    };
+private:
+    enum tag_t
+    {
+        OTHER,
+        DIRECTORY,
+        FILE,
+        NAME,
+        LENGTH,
+        XATTR,
+        KEY,
+        VALUE,
+        EXTENT,
+        PARTITION,
+        STARTBLOCK,
+        BYTEOFFSET,
+        BYTECOUNT,
+        FILEOFFSET
+    };
+    struct element_t
+    {
+        tag_t tag;
+        bool percentEncoded;
+        const char *text;
+    };
+    std::string indexFile;
+    int fd;
+    const char *addr;
+    unsigned long size;
+    const char *pos;
+    const char *released;
+    std::vector<element_t> elements;
+    std::vector<std::string> directories;
+    std::string key;
+    extent_t extent;
+    file_t file;
+
+    static tag_t getTag(const char *name, unsigned long length);
+    static std::string decode(const char *start, const char *end,
+            bool percentEncoded);
+    static bool parseName(std::string name, fuid_t *fuid);
+    void release();
+    void skip(const char *delim);
+    void setValue(tag_t tag, tag_t parent, std::string value);
+    bool closeElement(const char *textEnd);
+public:
+    IndexParser(std::string indexFile_);
+    ~IndexParser();
+    bool next(file_t *entry);
+};
@@ -17,8 +17,9 @@
 #include "ServerIncludes.h"
 
 LTFSDMCartridge::LTFSDMCartridge(boost::shared_ptr<Cartridge> c) :
-        cart(c), inProgress(0), pool(""), requested(false), state(
-                LTFSDMCartridge::TAPE_UNKNOWN), result(Error::OK)
+        cart(c), inProgress(0), pool(""), requested(false), remainingCap(
+                1024 * 1024 * c->get_remaining_cap()), state(
+                LTFSDMCartridge::TAPE_UNKNOWN)
 {
 }
 
@@ -27,29 +28,81 @@ void LTFSDMCartridge::update()
 {
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
-    cart = inventory->lookupCartridge(cart->GetObjectID());
+    boost::shared_ptr<Cartridge> c = inventory->lookupCartridge(
+            get_le()->GetObjectID());
+
+    // keep the previous information if the lookup failed
+    if (!c)
+        return;
+
+    update(c);
 }
 
-void LTFSDMCartridge::setInProgress(unsigned long size)
+void LTFSDMCartridge::update(boost::shared_ptr<Cartridge> c)
 
 {
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
+    boost::atomic_store(&cart, c);
+
+    // LTFS LE is authoritative: replace the locally maintained capacity
+    setRemainingCap(1024 * 1024 * c->get_remaining_cap());
+}
+
+void LTFSDMCartridge::setRemainingCap(unsigned long cap)
+
+{
+    unsigned long oldCap = remainingCap.exchange(cap);
+
+    inventory->updatePoolCap(getPool(), oldCap, cap);
+}
+
+unsigned long LTFSDMCartridge::getRemainingCap()
+
+{
+    return remainingCap;
+}
+
+/**
+ * Called by the data movers for each file. The capacity is maintained
+ * without a lock such that movers of different drives and the
+ * Scheduler do not serialize on the inventory lock.
+ */
+void LTFSDMCartridge::reduceRemainingCap(unsigned long size)
+
+{
+    unsigned long blockSize = inventory->getBlockSize();
+    unsigned long used;
+    unsigned long oldCap = remainingCap;
+    unsigned long newCap;
+
+    // data is written in full blocks, the index grows with each file
+    used = ((size + blockSize - 1) / blockSize) * blockSize
+            + Const::INDEX_OVERHEAD_PER_FILE;
+
+    do {
+        newCap = used < oldCap ? oldCap - used : 0;
+    } while (!remainingCap.compare_exchange_weak(oldCap, newCap));
+
+    inventory->updatePoolCap(getPool(), oldCap, newCap);
+}
+
+void LTFSDMCartridge::setInProgress(unsigned long size)
+
+{
     inProgress = size;
 }
 
 unsigned long LTFSDMCartridge::getInProgress()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     return inProgress;
 }
 
 void LTFSDMCartridge::setPool(std::string _pool)
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::lock_guard<std::mutex> lock(poolmtx);
 
     pool = _pool;
 }
@@ -57,48 +110,38 @@ void LTFSDMCartridge::setPool(std::string _pool)
 std::string LTFSDMCartridge::getPool()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::lock_guard<std::mutex> lock(poolmtx);
 
     return pool;
 }
 void LTFSDMCartridge::setState(state_t _state)
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     state = _state;
 
-    TRACE(Trace::always, this->get_le()->GetObjectID(), state);
+    TRACE(Trace::always, this->get_le()->GetObjectID(), _state);
 }
 
 LTFSDMCartridge::state_t LTFSDMCartridge::getState()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     return state;
 }
 
 bool LTFSDMCartridge::isRequested()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     return requested;
 }
 
 void LTFSDMCartridge::setRequested()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     requested = true;
 }
 
 void LTFSDMCartridge::unsetRequested()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     requested = false;
 }
@@ -16,14 +16,60 @@
  *******************************************************************************/
 #include "ServerIncludes.h"
 
+/** @page drive_performance Drive Performance
+
+    # Drive Performance
+
+    Each LTFSDMDrive keeps track of the throughput and of the errors
+    of its data transfers. This information is provided by the data
+    movers:
+
+    - Migration::transferData measures the time of the writes to tape,
+    - SelRecall::recall and TransRecall::recall measure the time of the
+      reads from tape.
+
+    The time of opening and positioning on tape is not included. Since
+    LTFS positions the tape at the start block of a file with its first
+    read, the first read of each file is not measured. Reads and writes
+    are accounted separately since their throughput differs. The
+    transfers of each type are accumulated by LTFSDMDrive::addTransfer
+    until Const::DRIVE_PERF_SAMPLE_SIZE bytes have been transferred. The
+    throughput of such a sample is added to an exponentially weighted
+    moving average (weight Const::DRIVE_PERF_WEIGHT) so that a drive
+    that degrades over time, e.g. by dirty heads, is detected.
+
+    Tape I/O errors are reported by LTFSDMDrive::addError. The outcomes
+    of the last Const::DRIVE_ERROR_WINDOW transfers are kept and the
+    errors among them are counted.
+
+    After each update LTFSDMInventory::checkDriveHealth compares the
+    drives with each other. A drive is degraded if
+
+    - its read or write throughput is less than Const::DRIVE_SLOW_RATIO
+      of the median of the same throughput of its peers, provided that
+      both have at least Const::DRIVE_PERF_MIN_SAMPLES samples of that
+      type, or
+    - at least Const::DRIVE_ERROR_THRESHOLD of its last transfers
+      failed.
+
+    A degraded drive still is used but the Scheduler prefers healthy drives
+    when mounting and unmounting cartridges (see
+    LTFSDMInventory::getDrivesByHealth). The state of a drive is shown by
+    the ltfsdm info drives command.
+ */
+
 LTFSDMDrive::LTFSDMDrive(boost::shared_ptr<Drive> d) :
         drive(d), busy(false), umountReqNum(Const::UNSET), umountReqPool(""), toUnBlock(
-                DataBase::NOOP), mtx(nullptr), wqp(nullptr)
+                DataBase::NOOP), numErrors(0), degraded(false), mtx(nullptr), wqp(
+                nullptr), cpuList("")
 {
+    for (perf_t& p : perf)
+        p = (perf_t ) { 0, std::chrono::steady_clock::duration::zero(), 0, 0 };
 }
 
 LTFSDMDrive::~LTFSDMDrive()
 {
+    delete (wqp);
     delete (mtx);
 }
 
@@ -32,35 +78,38 @@ void LTFSDMDrive::update()
 {
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
-    drive = inventory->lookupDrive(drive->GetObjectID());
+    boost::atomic_store(&drive,
+            inventory->lookupDrive(get_le()->GetObjectID()));
 }
 
-bool LTFSDMDrive::isBusy()
+void LTFSDMDrive::update(boost::shared_ptr<Drive> d)
 
 {
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
+    boost::atomic_store(&drive, d);
+}
+
+bool LTFSDMDrive::isBusy()
+
+{
     return busy;
 }
 
 void LTFSDMDrive::setBusy()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     busy = true;
 
-    TRACE(Trace::always, this->get_le()->GetObjectID(), busy);
+    TRACE(Trace::always, this->get_le()->GetObjectID(), busy.load());
 }
 
 void LTFSDMDrive::setFree()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     busy = false;
 
-    TRACE(Trace::always, this->get_le()->GetObjectID(), busy);
+    TRACE(Trace::always, this->get_le()->GetObjectID(), busy.load());
 }
 
 void LTFSDMDrive::setMoveReq(int reqnum, std::string pool)
@@ -100,24 +149,134 @@ void LTFSDMDrive::unsetMoveReq()
 void LTFSDMDrive::setToUnblock(DataBase::operation op)
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    DataBase::operation current = toUnBlock;
 
-    if (op < toUnBlock)
-        toUnBlock = op;
+    while (op < current && !toUnBlock.compare_exchange_weak(current, op))
+        ;
 }
 
 DataBase::operation LTFSDMDrive::getToUnblock()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     return toUnBlock;
 }
 
 void LTFSDMDrive::clearToUnblock()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
     toUnBlock = DataBase::NOOP;
 }
+
+void LTFSDMDrive::addOutcome(bool failed)
+
+{
+    outcomes.push_back(failed);
+    if (failed)
+        numErrors++;
+
+    if (outcomes.size() > Const::DRIVE_ERROR_WINDOW) {
+        if (outcomes.front())
+            numErrors--;
+        outcomes.pop_front();
+    }
+}
+
+void LTFSDMDrive::addTransfer(transfer_t type, unsigned long size,
+        std::chrono::steady_clock::duration duration)
+
+{
+    perf_t& p = perf[type];
+    long usecs;
+    double sample;
+
+    {
+        std::lock_guard<std::mutex> lock(perfmtx);
+
+        addOutcome(false);
+        p.sampleBytes += size;
+        p.sampleTime += duration;
+
+        if (p.sampleBytes < Const::DRIVE_PERF_SAMPLE_SIZE)
+            return;
+
+        usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+                p.sampleTime).count();
+
+        if (usecs > 0) {
+            sample = (double) p.sampleBytes * 1000000 / usecs;
+            if (p.numSamples == 0)
+                p.throughput = sample;
+            else
+                p.throughput = Const::DRIVE_PERF_WEIGHT * sample
+                        + (1 - Const::DRIVE_PERF_WEIGHT) * p.throughput;
+            p.numSamples++;
+        }
+
+        TRACE(Trace::always, get_le()->GetObjectID(), type, p.sampleBytes,
+                usecs, (unsigned long) p.throughput);
+
+        p.sampleBytes = 0;
+        p.sampleTime = std::chrono::steady_clock::duration::zero();
+    }
+
+    inventory->checkDriveHealth();
+}
+
+void LTFSDMDrive::addError()
+
+{
+    {
+        std::lock_guard<std::mutex> lock(perfmtx);
+
+        addOutcome(true);
+
+        TRACE(Trace::always, get_le()->GetObjectID(), numErrors,
+                outcomes.size());
+    }
+
+    inventory->checkDriveHealth();
+}
+
+unsigned long LTFSDMDrive::getThroughput(transfer_t type)
+
+{
+    std::lock_guard<std::mutex> lock(perfmtx);
+
+    return perf[type].throughput;
+}
+
+int LTFSDMDrive::getNumSamples(transfer_t type)
+
+{
+    std::lock_guard<std::mutex> lock(perfmtx);
+
+    return perf[type].numSamples;
+}
+
+int LTFSDMDrive::getNumErrors()
+
+{
+    std::lock_guard<std::mutex> lock(perfmtx);
+
+    return numErrors;
+}
+
+int LTFSDMDrive::getNumOutcomes()
+
+{
+    std::lock_guard<std::mutex> lock(perfmtx);
+
+    return outcomes.size();
+}
+
+bool LTFSDMDrive::isDegraded()
+
+{
+    return degraded;
+}
+
+bool LTFSDMDrive::setDegraded(bool _degraded)
+
+{
+    return degraded.exchange(_degraded);
+}
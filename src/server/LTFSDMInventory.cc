@@ -187,9 +187,11 @@ void LTFSDMInventory::remDrive(boost::shared_ptr<Drive> drive)
     THROW(Error::GENERAL_ERROR);
 }
 
-void LTFSDMInventory::lookupDrives(bool assigned_only, bool force)
+std::list<std::shared_ptr<LTFSDMDrive>> LTFSDMInventory::lookupDrives(
+bool assigned_only, bool force)
 {
     std::list<boost::shared_ptr<Drive> > drvs;
+    std::list<std::shared_ptr<LTFSDMDrive>> newDrives;
 
     if (sess && sess->is_alived()) {
         try {
@@ -209,7 +211,6 @@ void LTFSDMInventory::lookupDrives(bool assigned_only, bool force)
         } catch (AdminLibException& e) {
             MSG(LTFSDML0010E, "Inventory", "drive", sess->get_server().c_str(),
                     sess->get_port(), sess->get_fd(), e.what());
-            drives.clear();
             THROW(Error::GENERAL_ERROR);
         }
 
@@ -222,10 +223,10 @@ void LTFSDMInventory::lookupDrives(bool assigned_only, bool force)
         for (boost::shared_ptr<Drive> d : drvs) {
             TRACE(Trace::always, d->GetObjectID());
             MSG(LTFSDMS0052I, d->GetObjectID());
-            drives.push_back(std::make_shared<LTFSDMDrive>(d));
+            newDrives.push_back(std::make_shared<LTFSDMDrive>(d));
         }
 
-        return;
+        return newDrives;
     }
 
     THROW(Error::GENERAL_ERROR);
@@ -249,7 +250,8 @@ bool force)
                         sess->get_port(), sess->get_fd());
                 cart = *(cartridge_list.begin());
             } else
-                MSG(LTFSDML0017E, sess->get_server().c_str(), sess->get_port(),
+                MSG(LTFSDML0017E, cartridge_list.size(),
+                        sess->get_server().c_str(), sess->get_port(),
                         sess->get_fd());
         } catch (AdminLibException& e) {
             MSG(LTFSDML0010E, "Inventory", type.c_str(),
@@ -338,9 +340,11 @@ bool keep_on_drive)
     THROW(Error::GENERAL_ERROR);
 }
 
-void LTFSDMInventory::lookupCartridges(bool assigned_only, bool force)
+std::list<std::shared_ptr<LTFSDMCartridge>> LTFSDMInventory::lookupCartridges(
+bool assigned_only, bool force)
 {
     std::list<boost::shared_ptr<Cartridge>> crts;
+    std::list<std::shared_ptr<LTFSDMCartridge>> newCartridges;
 
     if (sess && sess->is_alived()) {
         try {
@@ -360,7 +364,6 @@ void LTFSDMInventory::lookupCartridges(bool assigned_only, bool force)
         } catch (AdminLibException& e) {
             MSG(LTFSDML0010E, "Inventory", "tape", sess->get_server().c_str(),
                     sess->get_port(), sess->get_fd(), e.what());
-            cartridges.clear();
             THROW(Error::GENERAL_ERROR);
         }
 
@@ -375,10 +378,10 @@ void LTFSDMInventory::lookupCartridges(bool assigned_only, bool force)
                 continue;
             TRACE(Trace::always, c->GetObjectID());
             MSG(LTFSDMS0054I, c->GetObjectID());
-            cartridges.push_back(std::make_shared<LTFSDMCartridge>(c));
+            newCartridges.push_back(std::make_shared<LTFSDMCartridge>(c));
         }
 
-        return;
+        return newCartridges;
     }
 
     THROW(Error::GENERAL_ERROR);
@@ -391,14 +394,14 @@ void LTFSDMInventory::updateCartridge(std::string tapeId)
         try {
             std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
-            for (std::shared_ptr<LTFSDMCartridge> c : cartridges) {
+            for (std::shared_ptr<LTFSDMCartridge> c : getCartridges()) {
                 if (c->get_le()->GetObjectID().compare(tapeId) == 0) {
                     MSG(LTFSDMS0106I, tapeId);
 
                     c->update();
 
                     c->setState(LTFSDMCartridge::TAPE_UNMOUNTED);
-                    for (std::shared_ptr<LTFSDMDrive> d : drives) {
+                    for (std::shared_ptr<LTFSDMDrive> d : getDrives()) {
                         TRACE(Trace::always, tapeId, c->get_le()->get_slot(),
                                 d->get_le()->get_slot());
                         if (c->get_le()->get_slot()
@@ -420,91 +423,428 @@ void LTFSDMInventory::updateCartridge(std::string tapeId)
     }
 }
 
+void LTFSDMInventory::reconcileCartridge(std::string tapeId)
+
+{
+    std::shared_ptr<LTFSDMCartridge> cart;
+
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    if ((cart = getCartridge(tapeId)) != nullptr)
+        cart->update();
+}
+
+void LTFSDMInventory::updateCartridgeAsync(std::string tapeId)
+
+{
+    wqu->enqueue(Const::UNSET, tapeId);
+}
+
 void LTFSDMInventory::inventorize()
 
 {
     std::ifstream conffile(Const::CONFIG_FILE);
     std::string line;
-    int i = 0;
 
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
 
-    for (std::shared_ptr<LTFSDMDrive> d : drives) {
+    std::list<std::shared_ptr<LTFSDMDrive>> newDrives;
+    std::list<std::shared_ptr<LTFSDMCartridge>> newCartridges;
+    std::map<std::string, std::shared_ptr<LTFSDMCartridge>> cartridgeMap;
+    std::map<std::string, unsigned long> newPoolCap;
+    std::list<std::pair<std::string, std::string>> remCartridges;
+    std::shared_ptr<const std::list<std::shared_ptr<LTFSDMDrive>>> driveList;
+    std::shared_ptr<const std::list<std::shared_ptr<LTFSDMCartridge>>> cartridgeList;
+
+    for (std::shared_ptr<LTFSDMDrive> d : getDrives()) {
         if (d->isBusy() == true) {
             MSG(LTFSDMS0103I, d->get_le()->GetObjectID());
             return;
         }
     }
 
-    for (std::shared_ptr<LTFSDMDrive> d : drives)
-        delete (d->wqp);
+    // a failing lookup leaves the current snapshots untouched
+    newDrives = lookupDrives();
 
-    drives.clear();
-    cartridges.clear();
+    newCartridges = lookupCartridges();
 
-    lookupDrives();
-
-    lookupCartridges();
-
-    cartridges.sort(
+    newCartridges.sort(
             [] (const std::shared_ptr<LTFSDMCartridge> c1, const std::shared_ptr<LTFSDMCartridge> c2)
             {   return (c1->get_le()->GetObjectID().compare(c2->get_le()->GetObjectID()) < 0);});
 
+    for (std::shared_ptr<LTFSDMCartridge> c : newCartridges)
+        cartridgeMap[c->get_le()->GetObjectID()] = c;
+
+    std::shared_ptr<const ConfigSnapshot> conf = Server::conf.getSnapshot();
+
     for (std::string poolname : Server::conf.getPools()) {
-        for (std::string cartridgeid : Server::conf.getPool(poolname)) {
-            if (getCartridge(cartridgeid) == nullptr) {
-                MSG(LTFSDMS0091W, cartridgeid, poolname);
-                Server::conf.poolRemove(poolname, cartridgeid);
+        newPoolCap[poolname] = 0;
+        for (std::string cartridgeid : conf->getPool(poolname)) {
+            std::map<std::string, std::shared_ptr<LTFSDMCartridge>>::iterator it =
+                    cartridgeMap.find(cartridgeid);
+            if (it == cartridgeMap.end()) {
+                remCartridges.push_back(
+                        std::make_pair(poolname, cartridgeid));
             } else {
-                if (getCartridge(cartridgeid)->getPool().compare(poolname)
-                        != 0) {
-                    MSG(LTFSDMS0078I, cartridgeid, poolname);
-                    getCartridge(cartridgeid)->setPool(poolname);
-                }
+                MSG(LTFSDMS0078I, cartridgeid, poolname);
+                it->second->setPool(poolname);
+                newPoolCap[poolname] += it->second->getRemainingCap();
             }
         }
     }
 
-    for (std::shared_ptr<LTFSDMCartridge> c : cartridges) {
-        c->setState(LTFSDMCartridge::TAPE_UNMOUNTED);
-        for (std::shared_ptr<LTFSDMDrive> d : drives) {
-            if (c->get_le()->get_slot() == d->get_le()->get_slot()) {
-                c->setState(LTFSDMCartridge::TAPE_MOUNTED);
-                if (c->get_le()->get_handling().compare("UNMOUNTED") == 0) {
-                    MSG(LTFSDML0020E, c->get_le()->GetObjectID());
-                    try {
-                        c->get_le()->Mount(d->get_le()->GetObjectID());
-                    } catch (AdminLibException& e) {
-                        MSG(LTFSDMS0100E, c->get_le()->GetObjectID(), e.what());
-                    } catch (const std::exception& e) {
-                        MSG(LTFSDMS0105E, c->get_le()->GetObjectID());
-                    }
-                }
-                break;
+    driveList = std::make_shared<
+            const std::list<std::shared_ptr<LTFSDMDrive>>>(std::move(newDrives));
+    cartridgeList = std::make_shared<
+            const std::list<std::shared_ptr<LTFSDMCartridge>>>(
+            std::move(newCartridges));
+
+    for (std::shared_ptr<LTFSDMCartridge> c : *cartridgeList)
+        setCartridgeState(c, LTFSDMSnapshot<LTFSDMDrive>(driveList));
+
+    /* publish the new snapshots, readers see either the old or the new list */
+    std::atomic_store(&drives, driveList);
+    std::atomic_store(&cartridges, cartridgeList);
+
+    {
+        std::lock_guard<std::mutex> caplock(capmtx);
+        poolRemainingCap.swap(newPoolCap);
+    }
+
+    for (std::pair<std::string, std::string> rem : remCartridges) {
+        MSG(LTFSDMS0091W, rem.second, rem.first);
+        Server::conf.poolRemove(rem.first, rem.second);
+    }
+
+    numDriveQueues = 0;
+    for (std::shared_ptr<LTFSDMDrive> drive : getDrives())
+        initDrive(drive);
+}
+
+void LTFSDMInventory::initDrive(std::shared_ptr<LTFSDMDrive> drive)
+
+{
+    std::stringstream threadName;
+
+    threadName << "pmig" << numDriveQueues++ << "-wq";
+    drive->wqp = new ThreadPool<std::string, std::string, long, long,
+            Migration::mig_info_t, std::shared_ptr<std::list<unsigned long>>,
+            std::shared_ptr<bool>>(&Migration::transferData,
+            Const::MAX_PREMIG_THREADS, threadName.str());
+    drive->cpuList = Affinity::getDriveCpus(drive->get_le()->GetObjectID(),
+            drive->get_le()->get_devname());
+    drive->wqp->setAffinity(drive->cpuList);
+    drive->mtx = new std::mutex();
+}
+
+void LTFSDMInventory::setCartridgeState(
+        std::shared_ptr<LTFSDMCartridge> cartridge)
+
+{
+    setCartridgeState(cartridge, getDrives());
+}
+
+/**
+ * Sets the state of a cartridge depending on whether it is located in
+ * a drive. If it is located in a drive but has not been mounted by
+ * LTFS LE that drive is returned, otherwise nullptr.
+ */
+std::shared_ptr<LTFSDMDrive> LTFSDMInventory::updateCartridgeState(
+        std::shared_ptr<LTFSDMCartridge> cartridge,
+        LTFSDMSnapshot<LTFSDMDrive> driveList)
+
+{
+    cartridge->setState(LTFSDMCartridge::TAPE_UNMOUNTED);
+    for (std::shared_ptr<LTFSDMDrive> d : driveList) {
+        if (cartridge->get_le()->get_slot() == d->get_le()->get_slot()) {
+            cartridge->setState(LTFSDMCartridge::TAPE_MOUNTED);
+            if (cartridge->get_le()->get_handling().compare("UNMOUNTED")
+                    == 0)
+                return d;
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+void LTFSDMInventory::mountCartridge(std::shared_ptr<LTFSDMCartridge> cartridge,
+        std::shared_ptr<LTFSDMDrive> drive)
+
+{
+    std::string tapeId = cartridge->get_le()->GetObjectID();
+
+    MSG(LTFSDML0020E, tapeId);
+    try {
+        cartridge->get_le()->Mount(drive->get_le()->GetObjectID());
+    } catch (AdminLibException& e) {
+        MSG(LTFSDMS0100E, tapeId, e.what());
+    } catch (const std::exception& e) {
+        MSG(LTFSDMS0105E, tapeId);
+    }
+}
+
+void LTFSDMInventory::setCartridgeState(
+        std::shared_ptr<LTFSDMCartridge> cartridge,
+        LTFSDMSnapshot<LTFSDMDrive> driveList)
+
+{
+    std::shared_ptr<LTFSDMDrive> drive;
+
+    if ((drive = updateCartridgeState(cartridge, driveList)) != nullptr)
+        mountCartridge(cartridge, drive);
+}
+
+/**
+ * Refreshes a single cartridge after it has been formatted or checked.
+ * Different to the full inventorize() the drive and cartridge objects
+ * are kept such that operations on other drives can continue.
+ */
+void LTFSDMInventory::inventorize(std::string tapeId)
+
+{
+    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::shared_ptr<LTFSDMCartridge> c;
+
+    if ((c = getCartridge(tapeId)) == nullptr) {
+        MSG(LTFSDMX0034E, tapeId);
+        return;
+    }
+
+    c->update();
+
+    setCartridgeState(c);
+}
+
+/**
+ * Differential refresh of the inventory. Different to inventorize() the
+ * information is retrieved from LTFS LE without holding the inventory
+ * lock. Afterwards only the entries that have been changed are updated
+ * in place: drives and cartridges that are in use are left untouched,
+ * the work queues of existing drives are kept and new snapshots are only
+ * published if drives or cartridges have been added or removed.
+ * Cartridges that do not exist anymore are removed from their pools.
+ * The work queue of a removed drive is deleted together with the drive
+ * object, i.e. after the last snapshot that contains it is released.
+ *
+ * The comparison with the previous snapshots is also done without the
+ * lock. The state is only set again for cartridges that have been added
+ * or whose slot or handling has changed, or that are located in a slot
+ * of a drive that has been added or removed. A cartridge that needs to
+ * be mounted by LTFS LE is set to TAPE_MOVING and its drive to busy, so
+ * the Scheduler does not use them. The mount itself is performed after
+ * the lock has been released.
+ */
+void LTFSDMInventory::refresh()
+
+{
+    std::list<std::shared_ptr<LTFSDMDrive>> currDrives;
+    std::list<std::shared_ptr<LTFSDMCartridge>> currCartridges;
+    std::map<std::string, std::shared_ptr<LTFSDMDrive>> driveMap;
+    std::map<std::string, std::shared_ptr<LTFSDMCartridge>> cartridgeMap;
+    std::list<std::shared_ptr<LTFSDMDrive>> newDrives;
+    std::list<std::shared_ptr<LTFSDMCartridge>> newCartridges;
+    std::list<std::shared_ptr<LTFSDMDrive>> addedDrives;
+    std::list<std::shared_ptr<LTFSDMCartridge>> addedCartridges;
+    std::list<std::string> remCartridges;
+    std::set<int> oldSlots;
+    std::set<int> newSlots;
+    std::set<std::string> changed;
+    std::list<std::pair<std::shared_ptr<LTFSDMCartridge>,
+            std::shared_ptr<LTFSDMDrive>>> toMount;
+    int numRemDrives = 0;
+
+    currDrives = lookupDrives();
+    currCartridges = lookupCartridges();
+
+    for (std::shared_ptr<LTFSDMDrive> d : currDrives) {
+        driveMap[d->get_le()->GetObjectID()] = d;
+        newSlots.insert(d->get_le()->get_slot());
+    }
+    for (std::shared_ptr<LTFSDMCartridge> c : currCartridges)
+        cartridgeMap[c->get_le()->GetObjectID()] = c;
+
+    for (std::shared_ptr<LTFSDMDrive> d : getDrives())
+        oldSlots.insert(d->get_le()->get_slot());
+
+    {
+        std::map<std::string, std::shared_ptr<LTFSDMCartridge>> oldMap;
+
+        for (std::shared_ptr<LTFSDMCartridge> c : getCartridges())
+            oldMap[c->get_le()->GetObjectID()] = c;
+
+        for (std::shared_ptr<LTFSDMCartridge> c : currCartridges) {
+            std::string tapeId = c->get_le()->GetObjectID();
+            std::map<std::string, std::shared_ptr<LTFSDMCartridge>>::iterator it =
+                    oldMap.find(tapeId);
+            int slot = c->get_le()->get_slot();
+            if (it == oldMap.end()
+                    || it->second->get_le()->get_slot() != slot
+                    || it->second->get_le()->get_handling().compare(
+                            c->get_le()->get_handling()) != 0
+                    || oldSlots.count(slot) != newSlots.count(slot)) {
+                TRACE(Trace::normal, tapeId);
+                changed.insert(tapeId);
             }
         }
     }
 
-    for (std::shared_ptr<LTFSDMDrive> drive : drives) {
-        std::stringstream threadName;
-        threadName << "pmig" << i++ << "-wq";
-        drive->wqp =
-                new ThreadPool<std::string, std::string, long, long,
-                        Migration::mig_info_t,
-                        std::shared_ptr<std::list<unsigned long>>,
-                        std::shared_ptr<bool>>(&Migration::transferData,
-                        Const::MAX_PREMIG_THREADS, threadName.str());
-        drive->mtx = new std::mutex();
+    std::unique_lock<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+
+    std::chrono::time_point<std::chrono::steady_clock> start =
+            std::chrono::steady_clock::now();
+
+    for (std::shared_ptr<LTFSDMDrive> d : getDrives()) {
+        std::string driveId = d->get_le()->GetObjectID();
+        std::map<std::string, std::shared_ptr<LTFSDMDrive>>::iterator it =
+                driveMap.find(driveId);
+        if (it == driveMap.end()) {
+            if (d->isBusy() == true) {
+                MSG(LTFSDMS0103I, driveId);
+                newDrives.push_back(d);
+            } else {
+                // the work queue is deleted with the last reference to it
+                TRACE(Trace::always, driveId);
+                numRemDrives++;
+            }
+            continue;
+        }
+        // a mount or unmount updates the drive itself
+        if (d->isBusy() == false)
+            d->update(it->second->get_le());
+        newDrives.push_back(d);
+        driveMap.erase(it);
     }
+
+    for (std::map<std::string, std::shared_ptr<LTFSDMDrive>>::iterator it =
+            driveMap.begin(); it != driveMap.end(); ++it) {
+        TRACE(Trace::always, it->first);
+        newDrives.push_back(it->second);
+        addedDrives.push_back(it->second);
+    }
+
+    for (std::shared_ptr<LTFSDMCartridge> c : getCartridges()) {
+        std::string tapeId = c->get_le()->GetObjectID();
+        std::map<std::string, std::shared_ptr<LTFSDMCartridge>>::iterator it =
+                cartridgeMap.find(tapeId);
+        LTFSDMCartridge::state_t state = c->getState();
+        bool inUse = (state == LTFSDMCartridge::TAPE_INUSE
+                || state == LTFSDMCartridge::TAPE_MOVING || c->isRequested());
+        if (it == cartridgeMap.end()) {
+            if (inUse) {
+                newCartridges.push_back(c);
+            } else {
+                TRACE(Trace::always, tapeId);
+                updatePoolCap(c->getPool(), c->getRemainingCap(), 0);
+                remCartridges.push_back(tapeId);
+            }
+            continue;
+        }
+        if (!inUse)
+            c->update(it->second->get_le());
+        newCartridges.push_back(c);
+        cartridgeMap.erase(it);
+    }
+
+    for (std::map<std::string, std::shared_ptr<LTFSDMCartridge>>::iterator it =
+            cartridgeMap.begin(); it != cartridgeMap.end(); ++it) {
+        TRACE(Trace::always, it->first);
+        newCartridges.push_back(it->second);
+        addedCartridges.push_back(it->second);
+    }
+
+    if (addedDrives.size() > 0 || numRemDrives > 0)
+        std::atomic_store(&drives,
+                std::make_shared<const std::list<std::shared_ptr<LTFSDMDrive>>>(
+                        std::move(newDrives)));
+
+    if (addedCartridges.size() > 0 || remCartridges.size() > 0) {
+        newCartridges.sort(
+                [] (const std::shared_ptr<LTFSDMCartridge> c1, const std::shared_ptr<LTFSDMCartridge> c2)
+                {   return (c1->get_le()->GetObjectID().compare(c2->get_le()->GetObjectID()) < 0);});
+        std::atomic_store(&cartridges,
+                std::make_shared<const std::list<std::shared_ptr<LTFSDMCartridge>>>(
+                        std::move(newCartridges)));
+    }
+
+    for (std::shared_ptr<LTFSDMDrive> d : addedDrives)
+        initDrive(d);
+
+    if (addedCartridges.size() > 0 || remCartridges.size() > 0) {
+        std::shared_ptr<const ConfigSnapshot> conf =
+                Server::conf.getSnapshot();
+
+        for (std::string poolname : Server::conf.getPools()) {
+            for (std::string tapeId : remCartridges) {
+                if (conf->getPool(poolname).count(tapeId) == 0)
+                    continue;
+                MSG(LTFSDMS0091W, tapeId, poolname);
+                Server::conf.poolRemove(poolname, tapeId);
+            }
+            for (std::shared_ptr<LTFSDMCartridge> c : addedCartridges) {
+                std::string tapeId = c->get_le()->GetObjectID();
+                if (conf->getPool(poolname).count(tapeId) == 0)
+                    continue;
+                MSG(LTFSDMS0078I, tapeId, poolname);
+                c->setPool(poolname);
+                updatePoolCap(poolname, 0, c->getRemainingCap());
+            }
+        }
+    }
+
+    for (std::shared_ptr<LTFSDMCartridge> c : getCartridges()) {
+        std::shared_ptr<LTFSDMDrive> drive;
+        LTFSDMCartridge::state_t state = c->getState();
+        if (changed.count(c->get_le()->GetObjectID()) == 0
+                || state == LTFSDMCartridge::TAPE_INUSE
+                || state == LTFSDMCartridge::TAPE_MOVING
+                || c->isRequested() == true)
+            continue;
+        if ((drive = updateCartridgeState(c, getDrives())) != nullptr
+                && drive->isBusy() == false) {
+            c->setState(LTFSDMCartridge::TAPE_MOVING);
+            drive->setBusy();
+            toMount.push_back(std::make_pair(c, drive));
+        }
+    }
+
+    MSG(LTFSDMS0124I, addedDrives.size(), numRemDrives,
+            addedCartridges.size(), remCartridges.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+
+    lock.unlock();
+
+    if (toMount.size() == 0)
+        return;
+
+    for (std::pair<std::shared_ptr<LTFSDMCartridge>,
+            std::shared_ptr<LTFSDMDrive>> m : toMount) {
+        mountCartridge(m.first, m.second);
+        lock.lock();
+        m.first->setState(LTFSDMCartridge::TAPE_MOUNTED);
+        m.second->setFree();
+        lock.unlock();
+    }
+
+    Scheduler::invoke();
 }
 
-LTFSDMInventory::LTFSDMInventory()
+LTFSDMInventory::LTFSDMInventory() :
+        drives(std::make_shared<const std::list<std::shared_ptr<LTFSDMDrive>>>()),
+        cartridges(std::make_shared<const std::list<std::shared_ptr<LTFSDMCartridge>>>()),
+        blockSize(0), wqu(nullptr), numDriveQueues(0)
 
 {
     std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
     struct stat statbuf;
     struct statfs statfsbuf;
 
+    /* capacity reconciliation with LTFS LE after synchronizing a cartridge */
+    wqu = new ThreadPool<std::string>(
+            [this] (std::string tapeId) {reconcileCartridge(tapeId);},
+            Const::MAX_INVENTORY_UPDATE_THREADS, "invupd-wq");
+
     try {
         connect(Const::LTFSLE_HOST, Const::LTFSLE_PORT);
     } catch (const std::exception& e) {
@@ -563,41 +903,108 @@ LTFSDMInventory::LTFSDMInventory()
     }
 }
 
-std::list<std::shared_ptr<LTFSDMDrive>> LTFSDMInventory::getDrives()
+LTFSDMSnapshot<LTFSDMDrive> LTFSDMInventory::getDrives()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
-    return drives;
+    return LTFSDMSnapshot<LTFSDMDrive>(std::atomic_load(&drives));
 }
 
 std::shared_ptr<LTFSDMDrive> LTFSDMInventory::getDrive(std::string driveid)
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
-    for (std::shared_ptr<LTFSDMDrive> drive : drives)
+    for (std::shared_ptr<LTFSDMDrive> drive : getDrives())
         if (drive->get_le()->GetObjectID().compare(driveid) == 0)
             return drive;
 
     return nullptr;
 }
 
-std::list<std::shared_ptr<LTFSDMCartridge>> LTFSDMInventory::getCartridges()
+std::list<std::shared_ptr<LTFSDMDrive>> LTFSDMInventory::getDrivesByHealth()
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+    std::list<std::shared_ptr<LTFSDMDrive>> healthy;
+    std::list<std::shared_ptr<LTFSDMDrive>> degraded;
+
+    for (std::shared_ptr<LTFSDMDrive> drive : getDrives()) {
+        if (drive->isDegraded())
+            degraded.push_back(drive);
+        else
+            healthy.push_back(drive);
+    }
 
-    return cartridges;
+    healthy.splice(healthy.end(), degraded);
+
+    return healthy;
+}
+
+unsigned long LTFSDMInventory::getPeerThroughput(
+        std::shared_ptr<LTFSDMDrive> drive, LTFSDMDrive::transfer_t type)
+
+{
+    std::vector<unsigned long> peers;
+
+    for (std::shared_ptr<LTFSDMDrive> peer : getDrives())
+        if (peer != drive
+                && peer->getNumSamples(type) >= Const::DRIVE_PERF_MIN_SAMPLES)
+            peers.push_back(peer->getThroughput(type));
+
+    if (peers.size() == 0)
+        return 0;
+
+    std::sort(peers.begin(), peers.end());
+
+    return peers[peers.size() / 2];
+}
+
+void LTFSDMInventory::checkDriveHealth()
+
+{
+    unsigned long median[LTFSDMDrive::NUM_TRANSFER_TYPES];
+    bool slow;
+    bool failing;
+
+    for (std::shared_ptr<LTFSDMDrive> drive : getDrives()) {
+        slow = false;
+
+        for (int i = 0; i < LTFSDMDrive::NUM_TRANSFER_TYPES; i++) {
+            LTFSDMDrive::transfer_t type =
+                    static_cast<LTFSDMDrive::transfer_t>(i);
+            median[type] = 0;
+            if (drive->getNumSamples(type) < Const::DRIVE_PERF_MIN_SAMPLES)
+                continue;
+            median[type] = getPeerThroughput(drive, type);
+            if (drive->getThroughput(type) < Const::DRIVE_SLOW_RATIO * median[type])
+                slow = true;
+        }
+
+        failing = drive->getNumErrors() >= Const::DRIVE_ERROR_THRESHOLD;
+
+        if (drive->setDegraded(slow || failing) == (slow || failing))
+            continue;
+
+        if (slow || failing)
+            MSG(LTFSDMS0132W, drive->get_le()->GetObjectID(),
+                    drive->getThroughput(LTFSDMDrive::WRITE) / (1024 * 1024),
+                    median[LTFSDMDrive::WRITE] / (1024 * 1024),
+                    drive->getThroughput(LTFSDMDrive::READ) / (1024 * 1024),
+                    median[LTFSDMDrive::READ] / (1024 * 1024),
+                    drive->getNumErrors(), drive->getNumOutcomes());
+        else
+            MSG(LTFSDMS0133I, drive->get_le()->GetObjectID());
+    }
+}
+
+LTFSDMSnapshot<LTFSDMCartridge> LTFSDMInventory::getCartridges()
+
+{
+    return LTFSDMSnapshot<LTFSDMCartridge>(std::atomic_load(&cartridges));
 }
 
 std::shared_ptr<LTFSDMCartridge> LTFSDMInventory::getCartridge(
         std::string cartridgeid)
 
 {
-    std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
-
-    for (std::shared_ptr<LTFSDMCartridge> cartridge : cartridges)
+    for (std::shared_ptr<LTFSDMCartridge> cartridge : getCartridges())
         if (cartridge->get_le()->GetObjectID().compare(cartridgeid) == 0)
             return cartridge;
 
@@ -631,6 +1038,9 @@ void LTFSDMInventory::poolCreate(std::string poolname)
         MSG(LTFSDMX0023E, poolname);
         THROW(Error::POOL_EXISTS);
     }
+
+    std::lock_guard<std::mutex> caplock(capmtx);
+    poolRemainingCap[poolname] = 0;
 }
 
 void LTFSDMInventory::poolDelete(std::string poolname)
@@ -652,6 +1062,9 @@ void LTFSDMInventory::poolDelete(std::string poolname)
             THROW(Error::GENERAL_ERROR);
         }
     }
+
+    std::lock_guard<std::mutex> caplock(capmtx);
+    poolRemainingCap.erase(poolname);
 }
 
 void LTFSDMInventory::poolAdd(std::string poolname, std::string cartridgeid)
@@ -687,6 +1100,7 @@ void LTFSDMInventory::poolAdd(std::string poolname, std::string cartridgeid)
     }
 
     cartridge->setPool(poolname);
+    updatePoolCap(poolname, 0, cartridge->getRemainingCap());
 }
 
 void LTFSDMInventory::poolRemove(std::string poolname, std::string cartridgeid)
@@ -721,9 +1135,37 @@ void LTFSDMInventory::poolRemove(std::string poolname, std::string cartridgeid)
         }
     }
 
+    updatePoolCap(poolname, cartridge->getRemainingCap(), 0);
     cartridge->setPool("");
 }
 
+void LTFSDMInventory::updatePoolCap(std::string poolname, unsigned long oldCap,
+        unsigned long newCap)
+
+{
+    std::lock_guard<std::mutex> lock(capmtx);
+
+    if (poolname.compare("") == 0)
+        return;
+
+    unsigned long& cap = poolRemainingCap[poolname];
+
+    cap = (cap + newCap > oldCap) ? cap + newCap - oldCap : 0;
+}
+
+unsigned long LTFSDMInventory::getPoolRemainingCap(std::string poolname)
+
+{
+    std::map<std::string, unsigned long>::iterator it;
+
+    std::lock_guard<std::mutex> lock(capmtx);
+
+    if ((it = poolRemainingCap.find(poolname)) == poolRemainingCap.end())
+        return 0;
+
+    return it->second;
+}
+
 void LTFSDMInventory::mount(std::string driveid, std::string cartridgeid,
         TapeMover::operation op)
 
@@ -762,7 +1204,7 @@ void LTFSDMInventory::mount(std::string driveid, std::string cartridgeid,
         MSG(LTFSDMS0100E, cartridgeid, e.what());
         drive->setFree();
         try {
-            inventorize();
+            refresh();
         } catch (const LTFSDMException& e) {
             MSG(LTFSDMS0101E, e.what());
         } catch (const std::exception& e) {
@@ -776,7 +1218,7 @@ void LTFSDMInventory::mount(std::string driveid, std::string cartridgeid,
         MSG(LTFSDMS0105E, cartridgeid);
         drive->setFree();
         try {
-            inventorize();
+            refresh();
         } catch (const LTFSDMException& e) {
             MSG(LTFSDMS0101E, e.what());
         } catch (const std::exception& e) {
@@ -817,7 +1259,7 @@ void LTFSDMInventory::unmount(std::string driveid, std::string cartridgeid)
         sleep(1);
         drive->setFree();
         try {
-            inventorize();
+            refresh();
         } catch (const LTFSDMException& e) {
             MSG(LTFSDMS0101E, e.what());
         } catch (const std::exception& e) {
@@ -828,7 +1270,7 @@ void LTFSDMInventory::unmount(std::string driveid, std::string cartridgeid)
         sleep(1);
         drive->setFree();
         try {
-            inventorize();
+            refresh();
         } catch (const LTFSDMException& e) {
             MSG(LTFSDMS0101E, e.what());
         } catch (const std::exception& e) {
@@ -853,8 +1295,12 @@ LTFSDMInventory::~LTFSDMInventory()
     try {
         MSG(LTFSDMS0099I);
 
-        for (std::shared_ptr<LTFSDMDrive> drive : drives)
+        for (std::shared_ptr<LTFSDMDrive> drive : getDrives()) {
             delete (drive->wqp);
+            drive->wqp = nullptr;
+        }
+
+        delete (wqu);
 
         disconnect();
     } catch (const std::exception& e) {
@@ -867,7 +1313,7 @@ LTFSDMInventory::~LTFSDMInventory()
 bool LTFSDMInventory::requestExists(long reqNum, std::string pool)
 
 {
-    for (std::shared_ptr<LTFSDMDrive> drive : drives) {
+    for (std::shared_ptr<LTFSDMDrive> drive : getDrives()) {
         TRACE(Trace::always, reqNum, drive->getMoveReqNum(),
                 drive->getMoveReqPool());
         if (drive->getMoveReqNum() == reqNum
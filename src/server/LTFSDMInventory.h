@@ -25,25 +25,82 @@
 
 using namespace ltfsadmin;
 
+/**
+    @brief Immutable version of the drive or of the cartridge list.
+
+    @details
+    The inventory publishes a new version of a list each time drives or
+    cartridges are added or removed. Readers iterate over the version
+    that has been current when LTFSDMInventory::getDrives or
+    LTFSDMInventory::getCartridges has been called without taking the
+    inventory lock. The list itself never changes, the state of the
+    drive and cartridge objects within can change.
+ */
+template<typename T> class LTFSDMSnapshot
+{
+private:
+    std::shared_ptr<const std::list<std::shared_ptr<T>>> items;
+public:
+    typedef typename std::list<std::shared_ptr<T>>::const_iterator const_iterator;
+    LTFSDMSnapshot(std::shared_ptr<const std::list<std::shared_ptr<T>>> _items) :
+            items(_items)
+    {
+    }
+    const_iterator begin() const
+    {
+        return items->begin();
+    }
+    const_iterator end() const
+    {
+        return items->end();
+    }
+    size_t size() const
+    {
+        return items->size();
+    }
+};
+
 class LTFSDMDrive
 {
+public:
+    enum transfer_t
+    {
+        READ, /**< 0 */
+        WRITE, /**< 1 */
+        NUM_TRANSFER_TYPES /**< 2 */
+    };
 private:
+    struct perf_t
+    {
+        unsigned long sampleBytes;
+        std::chrono::steady_clock::duration sampleTime;
+        double throughput;
+        int numSamples;
+    };
     boost::shared_ptr<Drive> drive;
-    bool busy;
+    std::atomic<bool> busy;
     int umountReqNum;
     std::string umountReqPool;
-    DataBase::operation toUnBlock;
+    std::atomic<DataBase::operation> toUnBlock;
+    std::mutex perfmtx;
+    perf_t perf[NUM_TRANSFER_TYPES];
+    std::list<bool> outcomes;
+    int numErrors;
+    std::atomic<bool> degraded;
+    void addOutcome(bool failed);
 public:
     std::mutex *mtx;
     ThreadPool<std::string, std::string, long, long, Migration::mig_info_t,
             std::shared_ptr<std::list<unsigned long>>, std::shared_ptr<bool>> *wqp;
+    std::string cpuList;
     LTFSDMDrive(boost::shared_ptr<Drive> d);
     ~LTFSDMDrive();
     boost::shared_ptr<Drive> get_le()
     {
-        return drive;
+        return boost::atomic_load(&drive);
     }
     void update();
+    void update(boost::shared_ptr<Drive> d);
     bool isBusy();
     void setBusy();
     void setFree();
@@ -54,15 +111,27 @@ public:
     void setToUnblock(DataBase::operation op);
     DataBase::operation getToUnblock();
     void clearToUnblock();
+    void addTransfer(transfer_t type, unsigned long size,
+            std::chrono::steady_clock::duration duration);
+    void addError();
+    unsigned long getThroughput(transfer_t type);
+    int getNumSamples(transfer_t type);
+    int getNumErrors();
+    int getNumOutcomes();
+    bool isDegraded();
+    bool setDegraded(bool _degraded);
 };
 
 class LTFSDMCartridge
 {
 private:
     boost::shared_ptr<Cartridge> cart;
-    unsigned long inProgress;
+    std::atomic<unsigned long> inProgress;
+    std::mutex poolmtx;
     std::string pool;
-    bool requested;
+    std::atomic<bool> requested;
+    std::atomic<unsigned long> remainingCap;
+    void setRemainingCap(unsigned long cap);
 public:
     enum state_t
     {
@@ -72,13 +141,19 @@ public:
         TAPE_UNMOUNTED,
         TAPE_INVALID,
         TAPE_UNKNOWN
-    } state;
+    };
+private:
+    std::atomic<state_t> state;
+public:
     LTFSDMCartridge(boost::shared_ptr<Cartridge> c);
     boost::shared_ptr<Cartridge> get_le()
     {
-        return cart;
+        return boost::atomic_load(&cart);
     }
     void update();
+    void update(boost::shared_ptr<Cartridge> c);
+    unsigned long getRemainingCap();
+    void reduceRemainingCap(unsigned long size);
     void setInProgress(unsigned long size);
     unsigned long getInProgress();
     void setPool(std::string _pool);
@@ -88,21 +163,21 @@ public:
     bool isRequested();
     void setRequested();
     void unsetRequested();
-
-    std::mutex mtx;
-    std::condition_variable cond;
-    Error result;
 };
 
 class LTFSDMInventory
 {
 private:
-    std::list<std::shared_ptr<LTFSDMDrive>> drives;
-    std::list<std::shared_ptr<LTFSDMCartridge>> cartridges;
+    std::shared_ptr<const std::list<std::shared_ptr<LTFSDMDrive>>> drives;
+    std::shared_ptr<const std::list<std::shared_ptr<LTFSDMCartridge>>> cartridges;
     boost::shared_ptr<LTFSAdminSession> sess;
     boost::shared_ptr<LTFSNode> node;
     std::string mountPoint;
     unsigned long blockSize;
+    std::mutex capmtx;
+    std::map<std::string, unsigned long> poolRemainingCap;
+    ThreadPool<std::string> *wqu;
+    int numDriveQueues;
 
     void connect(std::string node_addr, unsigned short int port_num);
     void disconnect();
@@ -110,11 +185,23 @@ private:
 
     void addDrive(std::string serial);
     void remDrive(boost::shared_ptr<Drive> drive);
-    void lookupDrives(bool assigned_only = true, bool force = false);
+    std::list<std::shared_ptr<LTFSDMDrive>> lookupDrives(bool assigned_only =
+            true, bool force = false);
     void addCartridge(std::string barcode, std::string drive_serial);
     void remCartridge(boost::shared_ptr<Cartridge> cartridge,
             bool keep_on_drive = false);
-    void lookupCartridges(bool assigned_only = false, bool force = false);
+    std::list<std::shared_ptr<LTFSDMCartridge>> lookupCartridges(
+            bool assigned_only = false, bool force = false);
+    void reconcileCartridge(std::string tapeId);
+    void initDrive(std::shared_ptr<LTFSDMDrive> drive);
+    std::shared_ptr<LTFSDMDrive> updateCartridgeState(
+            std::shared_ptr<LTFSDMCartridge> cartridge,
+            LTFSDMSnapshot<LTFSDMDrive> driveList);
+    void mountCartridge(std::shared_ptr<LTFSDMCartridge> cartridge,
+            std::shared_ptr<LTFSDMDrive> drive);
+    void setCartridgeState(std::shared_ptr<LTFSDMCartridge> cartridge);
+    void setCartridgeState(std::shared_ptr<LTFSDMCartridge> cartridge,
+            LTFSDMSnapshot<LTFSDMDrive> driveList);
 public:
     LTFSDMInventory();
     ~LTFSDMInventory();
@@ -125,11 +212,18 @@ public:
     boost::shared_ptr<Cartridge> lookupCartridge(std::string id, bool force =
             false);
     void updateCartridge(std::string tapeId);
+    void updateCartridgeAsync(std::string tapeId);
     void inventorize();
-
-    std::list<std::shared_ptr<LTFSDMDrive>> getDrives();
+    void inventorize(std::string tapeId);
+    void refresh();
+
+    LTFSDMSnapshot<LTFSDMDrive> getDrives();
+    std::list<std::shared_ptr<LTFSDMDrive>> getDrivesByHealth();
+    unsigned long getPeerThroughput(std::shared_ptr<LTFSDMDrive> drive,
+            LTFSDMDrive::transfer_t type);
+    void checkDriveHealth();
     std::shared_ptr<LTFSDMDrive> getDrive(std::string driveid);
-    std::list<std::shared_ptr<LTFSDMCartridge>> getCartridges();
+    LTFSDMSnapshot<LTFSDMCartridge> getCartridges();
     std::shared_ptr<LTFSDMCartridge> getCartridge(std::string cartridgeid);
 
     void update(std::shared_ptr<LTFSDMDrive>);
@@ -139,6 +233,9 @@ public:
     void poolDelete(std::string poolname);
     void poolAdd(std::string poolname, std::string cartridgeid);
     void poolRemove(std::string poolname, std::string cartridgeid);
+    void updatePoolCap(std::string poolname, unsigned long oldCap,
+            unsigned long newCap);
+    unsigned long getPoolRemainingCap(std::string poolname);
 
     void mount(std::string driveid, std::string cartridgeid,
             TapeMover::operation op);
@@ -50,7 +50,11 @@
     MessageParser::poolAddMessage | pool add command
     MessageParser::poolRemoveMessage | pool remove command
     MessageParser::infoPoolsMessage | info pools command
+    MessageParser::infoThreadsMessage | info threads command
+    MessageParser::infoCatalogMessage | info catalog command
     MessageParser::retrieveMessage | retrieve command
+    MessageParser::rebuildMessage | rebuild command
+    MessageParser::reconcileMessage | reconcile command
 
     For selective recall and migration the file names need to be transferred
     from the client to the backend. This is handled within the MessageParser::getObjects
@@ -152,14 +156,7 @@ void MessageParser::getObjects(LTFSDmCommServer *command, long localReqNumber,
 
         if (cont == false) {
             for (std::string pool : pools) {
-                unsigned long free = 0;
-                for (std::string cartridgeid : Server::conf.getPool(pool)) {
-                    std::shared_ptr<LTFSDMCartridge> cart =
-                            inventory->getCartridge(cartridgeid);
-                    if (cart != nullptr)
-                        free += cart->get_le()->get_remaining_cap();
-                }
-                free *= (1024*1024);
+                unsigned long free = inventory->getPoolRemainingCap(pool);
                 if (fopt->getRequestSize() > free) {
                     TRACE(Trace::always, fopt->getRequestSize(), free);
                     error = static_cast<int>(Error::POOL_TOO_SMALL);
@@ -264,7 +261,6 @@ void MessageParser::migrationMessage(long key, LTFSDmCommServer *command,
     std::string pool;
     int error = static_cast<int>(Error::OK);
     Migration *mig = nullptr;
-    std::set<std::string> allpools;
 
     TRACE(Trace::normal, keySent);
 
@@ -276,14 +272,14 @@ void MessageParser::migrationMessage(long key, LTFSDmCommServer *command,
     requestNumber = migreq.reqnumber();
     pid = migreq.pid();
 
-    if (Server::terminate == false) {
+    if (Server::terminate == false && Server::drainTerminate == false) {
         std::stringstream poolss(migreq.pools());
 
         {
-            std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+            std::shared_ptr<const ConfigSnapshot> conf =
+                    Server::conf.getSnapshot();
             while (std::getline(poolss, pool, ',')) {
-                allpools = Server::conf.getPools();
-                if (allpools.find(pool) == allpools.end()) {
+                if (conf->poolExists(pool) == false) {
                     error = static_cast<int>(Error::NOT_ALL_POOLS_EXIST);
                     break;
                 }
@@ -357,7 +353,7 @@ void MessageParser::selRecallMessage(long key, LTFSDmCommServer *command,
     requestNumber = recreq.reqnumber();
     pid = recreq.pid();
 
-    if (Server::terminate == false)
+    if (Server::terminate == false && Server::drainTerminate == false)
         srec = new SelRecall(pid, requestNumber, recreq.state());
     else
         error = static_cast<int>(Error::TERMINATING);
@@ -436,20 +432,26 @@ void MessageParser::stopMessage(long key, LTFSDmCommServer *command,
     TRACE(Trace::always, __PRETTY_FUNCTION__);
     const LTFSDmProtocol::LTFSDmStopRequest stopreq = command->stoprequest();
     long keySent = stopreq.key();
-    SQLStatement stmt;
-    int state;
-    int numreqs;
+    bool drain = stopreq.drain() && !stopreq.forced() && !stopreq.finish();
+    bool report = true;
+    bool done;
+    long queued = Const::UNSET;
+    long inProgress = Const::UNSET;
 
-    TRACE(Trace::normal, keySent);
+    TRACE(Trace::normal, keySent, drain);
 
     if (key != keySent) {
         MSG(LTFSDMS0008E, keySent);
         return;
     }
 
-    MSG(LTFSDMS0009I);
-
-    Server::terminate = true;
+    if (drain) {
+        MSG(LTFSDMS0121I);
+        Server::drainTerminate = true;
+    } else {
+        MSG(LTFSDMS0009I);
+        Server::terminate = true;
+    }
 
     if (stopreq.forced()) {
         Server::forcedTerminate = true;
@@ -462,50 +464,48 @@ void MessageParser::stopMessage(long key, LTFSDmCommServer *command,
         Scheduler::updcond.notify_all();
     }
 
+    // other stop commands may wait for different conditions
+    reqCounter.invoke();
+
     Server::termcond.notify_one();
     reclock->unlock();
 
+    /*
+     * Each change of the number of outstanding requests is sent to the
+     * client until all of them are processed. If the client disappears
+     * the stop is continued without further reporting.
+     */
     do {
-        numreqs = 0;
-
-        if (Server::forcedTerminate == false && Server::finishTerminate == false) {
-            stmt(MessageParser::ALL_REQUESTS);
-            stmt.prepare();
-            while (stmt.step(&state)) {
-                if (state == DataBase::REQ_INPROGRESS) {
-                    numreqs++;
-                }
-            }
-            stmt.finalize();
-            TRACE(Trace::always, numreqs);
-        }
+        done = reqCounter.wait(&queued, &inProgress);
+
+        if (report == false)
+            continue;
 
         LTFSDmProtocol::LTFSDmStopResp *stopresp = command->mutable_stopresp();
 
-        stopresp->set_success(numreqs == 0);
+        stopresp->set_success(done);
+        stopresp->set_queued(queued);
+        stopresp->set_inprogress(inProgress);
 
         try {
             command->send();
         } catch (const std::exception& e) {
             TRACE(Trace::error, e.what());
             MSG(LTFSDMS0007E);
-            return;
+            report = false;
         }
+    } while (!done);
 
-        if (numreqs > 0) {
-            try {
-                command->recv();
-            } catch (const std::exception& e) {
-                TRACE(Trace::error, e.what());
-                MSG(LTFSDMS0006E);
-                return;
-            }
-        }
-    } while (numreqs > 0);
+    TRACE(Trace::always, queued, inProgress);
 
-    TRACE(Trace::always, numreqs);
+    if (drain && Server::terminate == false) {
+        MSG(LTFSDMS0009I);
+        Server::terminate = true;
+        reqCounter.invoke();
+    }
 
     Scheduler::invoke();
+    recallCache.invoke();
 
     kill(getpid(), SIGUSR1);
 }
@@ -761,7 +761,6 @@ void MessageParser::infoDrivesMessage(long key, LTFSDmCommServer *command)
     }
 
     {
-        std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
         for (std::shared_ptr<LTFSDMDrive> d : inventory->getDrives()) {
             LTFSDmProtocol::LTFSDmInfoDrivesResp *infodrivesresp =
                     command->mutable_infodrivesresp();
@@ -771,6 +770,11 @@ void MessageParser::infoDrivesMessage(long key, LTFSDmCommServer *command)
             infodrivesresp->set_slot(d->get_le()->get_slot());
             infodrivesresp->set_status(d->get_le()->get_status());
             infodrivesresp->set_busy(d->isBusy());
+            infodrivesresp->set_writethroughput(
+                    d->getThroughput(LTFSDMDrive::WRITE));
+            infodrivesresp->set_degraded(d->isDegraded());
+            infodrivesresp->set_readthroughput(
+                    d->getThroughput(LTFSDMDrive::READ));
 
             try {
                 command->send();
@@ -790,6 +794,9 @@ void MessageParser::infoDrivesMessage(long key, LTFSDmCommServer *command)
     infodrivesresp->set_slot(0);
     infodrivesresp->set_status("");
     infodrivesresp->set_busy(false);
+    infodrivesresp->set_writethroughput(0);
+    infodrivesresp->set_degraded(false);
+    infodrivesresp->set_readthroughput(0);
 
     try {
         command->send();
@@ -816,7 +823,6 @@ void MessageParser::infoTapesMessage(long key, LTFSDmCommServer *command)
     }
 
     {
-        std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
         for (std::shared_ptr<LTFSDMCartridge> c : inventory->getCartridges()) {
             LTFSDmProtocol::LTFSDmInfoTapesResp *infotapesresp =
                     command->mutable_infotapesresp();
@@ -824,7 +830,8 @@ void MessageParser::infoTapesMessage(long key, LTFSDmCommServer *command)
             infotapesresp->set_id(c->get_le()->GetObjectID());
             infotapesresp->set_slot(c->get_le()->get_slot());
             infotapesresp->set_totalcap(c->get_le()->get_total_cap()/1024);
-            infotapesresp->set_remaincap(c->get_le()->get_remaining_cap()/1024);
+            infotapesresp->set_remaincap(
+                    c->getRemainingCap() / (1024 * 1024 * 1024));
             // the size of the reclaimable space is an estimation
             infotapesresp->set_reclaimable(
                     (c->get_le()->get_total_blocks()
@@ -985,6 +992,7 @@ void MessageParser::poolAddMessage(long key, LTFSDmCommServer *command)
     bool wait;
     std::string poolName;
     std::list<std::string> tapeids;
+    std::list<std::string> waitids;
     std::shared_ptr<LTFSDMCartridge> cartridge;
     std::string tapeStatus;
     int response;
@@ -1086,17 +1094,30 @@ void MessageParser::poolAddMessage(long key, LTFSDmCommServer *command)
             response = static_cast<int>(Error::GENERAL_ERROR);
         }
 
+        // format and check requests are processed in parallel
         if (wait) {
-            if ((cartridge = inventory->getCartridge(tapeid)) == nullptr) {
-                MSG(LTFSDMX0034E, tapeid);
-                response = static_cast<int>(Error::TAPE_NOT_EXISTS);
-                break;
-            }
-            std::unique_lock<std::mutex> lock(cartridge->mtx);
-            Scheduler::invoke();
-            cartridge->cond.wait(lock);
-            response = static_cast<int>(cartridge->result);
+            waitids.push_back(tapeid);
+            continue;
+        }
+
+        LTFSDmProtocol::LTFSDmPoolResp *poolresp = command->mutable_poolresp();
+
+        poolresp->set_tapeid(tapeid);
+        poolresp->set_response(response);
+
+        try {
+            command->send();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+            MSG(LTFSDMS0007E);
         }
+    }
+
+    if (waitids.size() > 0)
+        Scheduler::invoke();
+
+    for (std::string tapeid : waitids) {
+        response = static_cast<int>(TapeHandler::waitRequest(tapeid));
 
         LTFSDmProtocol::LTFSDmPoolResp *poolresp = command->mutable_poolresp();
 
@@ -1184,6 +1205,7 @@ void MessageParser::infoPoolsMessage(long key, LTFSDmCommServer *command)
 
     {
         std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
+        std::shared_ptr<const ConfigSnapshot> conf = Server::conf.getSnapshot();
         for (std::string poolname : Server::conf.getPools()) {
             int numCartridges = 0;
             unsigned long total = 0;
@@ -1193,14 +1215,14 @@ void MessageParser::infoPoolsMessage(long key, LTFSDmCommServer *command)
             LTFSDmProtocol::LTFSDmInfoPoolsResp *infopoolsresp =
                     command->mutable_infopoolsresp();
 
-            for (std::string cartridgeid : Server::conf.getPool(poolname)) {
+            for (std::string cartridgeid : conf->getPool(poolname)) {
                 if ((c = inventory->getCartridge(cartridgeid)) == nullptr) {
                     MSG(LTFSDMX0034E, cartridgeid);
                     Server::conf.poolRemove(poolname, cartridgeid);
                 } else {
                     numCartridges++;
                     total += c->get_le()->get_total_cap();
-                    free += c->get_le()->get_remaining_cap();
+                    free += c->getRemainingCap() / (1024 * 1024);
                 }
                 // unref?
             }
@@ -1237,6 +1259,127 @@ void MessageParser::infoPoolsMessage(long key, LTFSDmCommServer *command)
     }
 }
 
+void MessageParser::infoThreadsMessage(long key, LTFSDmCommServer *command)
+
+{
+    TRACE(Trace::always, __PRETTY_FUNCTION__);
+    const LTFSDmProtocol::LTFSDmInfoThreadsRequest infothreads =
+            command->infothreadsrequest();
+    long keySent = infothreads.key();
+
+    TRACE(Trace::normal, keySent);
+
+    if (key != keySent) {
+        MSG(LTFSDMS0008E, keySent);
+        return;
+    }
+
+    for (ThreadPoolStats::stats_t stats : ThreadPoolStats::getAll()) {
+        LTFSDmProtocol::LTFSDmInfoThreadsResp *infothreadsresp =
+                command->mutable_infothreadsresp();
+
+        infothreadsresp->set_name(stats.name);
+        infothreadsresp->set_maxthreads(stats.maxThreads);
+        infothreadsresp->set_started(stats.started);
+        infothreadsresp->set_active(stats.active);
+        infothreadsresp->set_queued(stats.queued);
+        infothreadsresp->set_completed(stats.completed);
+        infothreadsresp->clear_waittime();
+        infothreadsresp->clear_runtime();
+        for (int i = 0; i < ThreadPoolStats::NUM_BUCKETS; i++) {
+            infothreadsresp->add_waittime(stats.waitTime[i]);
+            infothreadsresp->add_runtime(stats.runTime[i]);
+        }
+
+        try {
+            command->send();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+            MSG(LTFSDMS0007E);
+            return;
+        }
+    }
+
+    LTFSDmProtocol::LTFSDmInfoThreadsResp *infothreadsresp =
+            command->mutable_infothreadsresp();
+
+    infothreadsresp->set_name("");
+    infothreadsresp->set_maxthreads(0);
+    infothreadsresp->set_started(0);
+    infothreadsresp->set_active(0);
+    infothreadsresp->set_queued(0);
+    infothreadsresp->set_completed(0);
+    infothreadsresp->clear_waittime();
+    infothreadsresp->clear_runtime();
+
+    try {
+        command->send();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0007E);
+    }
+}
+
+void MessageParser::infoCatalogMessage(long key, LTFSDmCommServer *command)
+
+{
+    TRACE(Trace::always, __PRETTY_FUNCTION__);
+    const LTFSDmProtocol::LTFSDmInfoCatalogRequest infocatalog =
+            command->infocatalogrequest();
+    long keySent = infocatalog.key();
+    std::string tapeId = infocatalog.tapeid();
+    Catalog::entry_t entry;
+    int error = static_cast<int>(Error::OK);
+
+    TRACE(Trace::normal, keySent, tapeId);
+
+    if (key != keySent) {
+        MSG(LTFSDMS0008E, keySent);
+        return;
+    }
+
+    if (Catalog::isAvailable()) {
+        Catalog::TapeFiles tapeFiles(tapeId);
+
+        while (tapeFiles.next(&entry)) {
+            LTFSDmProtocol::LTFSDmInfoCatalogResp *infocatalogresp =
+                    command->mutable_infocatalogresp();
+
+            infocatalogresp->set_error(error);
+            infocatalogresp->set_startblock(entry.startBlock);
+            infocatalogresp->set_filesize(entry.size);
+            infocatalogresp->set_state(entry.state);
+            infocatalogresp->set_filename(entry.fileName);
+
+            try {
+                command->send();
+            } catch (const std::exception& e) {
+                TRACE(Trace::error, e.what());
+                MSG(LTFSDMS0007E);
+                return;
+            }
+        }
+    } else {
+        error = static_cast<int>(Error::GENERAL_ERROR);
+    }
+
+    LTFSDmProtocol::LTFSDmInfoCatalogResp *infocatalogresp =
+            command->mutable_infocatalogresp();
+
+    infocatalogresp->set_error(error);
+    infocatalogresp->set_startblock(Const::UNSET);
+    infocatalogresp->set_filesize(0);
+    infocatalogresp->set_state(Const::UNSET);
+    infocatalogresp->set_filename("");
+
+    try {
+        command->send();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0007E);
+    }
+}
+
 void MessageParser::retrieveMessage(long key, LTFSDmCommServer *command)
 
 {
@@ -1254,7 +1397,7 @@ void MessageParser::retrieveMessage(long key, LTFSDmCommServer *command)
     }
 
     try {
-        inventory->inventorize();
+        inventory->refresh();
     } catch (const LTFSDMException& e) {
         MSG(LTFSDMS0101E, e.what());
         error = static_cast<int>(e.getError());
@@ -1275,6 +1418,64 @@ void MessageParser::retrieveMessage(long key, LTFSDmCommServer *command)
     }
 }
 
+void MessageParser::rebuildMessage(long key, LTFSDmCommServer *command)
+
+{
+    TRACE(Trace::always, __PRETTY_FUNCTION__);
+    const LTFSDmProtocol::LTFSDmRebuildRequest rebuildreq =
+            command->rebuildrequest();
+    long keySent = rebuildreq.key();
+    std::string tapeId = rebuildreq.tapeid();
+    std::string indexFile = rebuildreq.indexfile();
+    int error = static_cast<int>(Error::OK);
+    long numFiles = 0;
+
+    TRACE(Trace::normal, keySent, tapeId, indexFile);
+
+    if (key != keySent) {
+        MSG(LTFSDMS0008E, keySent);
+        return;
+    }
+
+    try {
+        numFiles = Catalog::rebuild(tapeId, indexFile);
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        error = static_cast<int>(Error::GENERAL_ERROR);
+    }
+
+    LTFSDmProtocol::LTFSDmRebuildResp *rebuildresp =
+            command->mutable_rebuildresp();
+
+    rebuildresp->set_error(error);
+    rebuildresp->set_numfiles(numFiles);
+
+    try {
+        command->send();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0007E);
+    }
+}
+
+void MessageParser::reconcileMessage(long key, LTFSDmCommServer *command)
+
+{
+    TRACE(Trace::always, __PRETTY_FUNCTION__);
+    const LTFSDmProtocol::LTFSDmReconcileRequest reconcilereq =
+            command->reconcilerequest();
+    long keySent = reconcilereq.key();
+
+    TRACE(Trace::normal, keySent, reconcilereq.cleanup());
+
+    if (key != keySent) {
+        MSG(LTFSDMS0008E, keySent);
+        return;
+    }
+
+    Reconcile(command, reconcilereq.cleanup()).run();
+}
+
 void MessageParser::run(long key, LTFSDmCommServer command,
         std::shared_ptr<Connector> connector)
 
@@ -1335,8 +1536,16 @@ void MessageParser::run(long key, LTFSDmCommServer command,
                     poolRemoveMessage(key, &command);
                 } else if (command.has_infopoolsrequest()) {
                     infoPoolsMessage(key, &command);
+                } else if (command.has_infothreadsrequest()) {
+                    infoThreadsMessage(key, &command);
+                } else if (command.has_infocatalogrequest()) {
+                    infoCatalogMessage(key, &command);
                 } else if (command.has_retrieverequest()) {
                     retrieveMessage(key, &command);
+                } else if (command.has_rebuildrequest()) {
+                    rebuildMessage(key, &command);
+                } else if (command.has_reconcilerequest()) {
+                    reconcileMessage(key, &command);
                 } else {
                     TRACE(Trace::error, "unkown command\n");
                 }
@@ -20,7 +20,6 @@ class MessageParser
 
 {
 private:
-    static const std::string ALL_REQUESTS;
     static const std::string INFO_ALL_REQUESTS;
     static const std::string INFO_ONE_REQUEST;
     static const std::string INFO_ALL_JOBS;
@@ -54,7 +53,11 @@ private:
     static void poolAddMessage(long key, LTFSDmCommServer *command);
     static void poolRemoveMessage(long key, LTFSDmCommServer *command);
     static void infoPoolsMessage(long key, LTFSDmCommServer *command);
+    static void infoThreadsMessage(long key, LTFSDmCommServer *command);
+    static void infoCatalogMessage(long key, LTFSDmCommServer *command);
     static void retrieveMessage(long key, LTFSDmCommServer *command);
+    static void rebuildMessage(long key, LTFSDmCommServer *command);
+    static void reconcileMessage(long key, LTFSDmCommServer *command);
 public:
     MessageParser()
     {
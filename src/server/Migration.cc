@@ -257,8 +257,22 @@
 
     In the data transfer case the Migration::transferData method is executed
     and in case of changing the migration state it is the
-    Migration::changeFileState method. Each of these methods operate on a
-    single file.
+    Migration::changeFileStates method. Migration::transferData operates on a
+    single file. For the migration state change the files are collected in
+    batches of up to Const::STUBBING_BATCH_SIZE files and each batch is
+    processed by a single thread calling Migration::changeFileState for each
+    of its files. This avoids a hand-over to a ThreadPool thread for each
+    single file which otherwise dominates the stubbing time of small files.
+    The inode numbers of the processed files are collected in a list that
+    belongs to the batch. Therefore Migration::changeFileState does not
+    need to lock Migration::pmigmtx. It is only taken once at the end of
+    the batch to merge that list into the list of the request.
+
+    When a job is added Migration::addJob also stores the file handle
+    provided by FsObj::getFileHandle within the JOB_QUEUE table. Both
+    methods open the file by that handle to avoid another path lookup
+    through the overlay file system. If this is not possible (e.g. the
+    file system does not support file handles) the file name is used.
 
     The following table provides a sequence of changes of different items
     that are changing during the migration of a resident file:
@@ -318,17 +332,23 @@
     For data transfer the following steps are performed:
 
     -# In a loop the data is read from disk and written to tape.
+    -# The time spent writing to tape is reported to the drive by
+       LTFSDMDrive::addTransfer, see @subpage drive_performance.
     -# The FILE_PATH attribute is set on the data file on tape.
     -# A symbolic link is created by recreating the original
        full path on tape pointing to the corresponding data file.
     -# The status object @ref Status "mrStatus" gets updated
        for the output statistics.
+    -# The locally maintained remaining capacity of the cartridge is
+       reduced (LTFSDMCartridge::reduceRemainingCap). It is reconciled
+       with LTFS LE asynchronously after the index has been synchronized.
     -# The tape is added to the attribute of the data file on tape.
 
     For data transfer each file needs to be written continuously on tape.
     Since the copy of data from disk to tape is performed in a loop by
     doing the reads and writes this loop is serialized by
-    a std::mutex LTFSDMDrive::mtx.
+    a std::mutex LTFSDMDrive::mtx. The data of large files is read by
+    several threads in parallel, see @subpage chunk_reader.
 
     ### Migration::changeFileState
 
@@ -371,6 +391,8 @@ FsObj::file_state Migration::checkState(std::string fileName, FsObj *fso)
     } else {
         if (numReplica != 0) {
             FsObj::mig_target_attr_t attr = fso->getAttribute();
+            std::shared_ptr<const ConfigSnapshot> conf =
+                    Server::conf.getSnapshot();
             for (int i = 0; i < 3; i++) {
                 if (std::string("").compare(attr.tapeInfo[i].tapeId) == 0) {
                     if (i == 0) {
@@ -381,20 +403,8 @@ FsObj::file_state Migration::checkState(std::string fileName, FsObj *fso)
                         break;
                     }
                 }
-                bool tapeFound = false;
-                for (std::string pool : pools) {
-                    std::lock_guard<std::recursive_mutex> lock(
-                            LTFSDMInventory::mtx);
-                    for (std::string cart : Server::conf.getPool(pool)) {
-                        if (cart.compare(attr.tapeInfo[i].tapeId) == 0) {
-                            tapeFound = true;
-                            break;
-                        }
-                    }
-                    if (tapeFound)
-                        break;
-                }
-                if (!tapeFound) {
+                if (pools.count(
+                        conf->getTapePool(attr.tapeInfo[i].tapeId)) == 0) {
                     MSG(LTFSDMS0067E, fileName, attr.tapeInfo[i].tapeId);
                     state = FsObj::FAILED;
                     break;
@@ -414,6 +424,7 @@ void Migration::addJob(std::string fileName)
     FsObj::file_state state;
     SQLStatement stmt;
     fuid_t fuid;
+    std::string fileHandle;
 
     try {
         FsObj fso(fileName);
@@ -427,10 +438,11 @@ void Migration::addJob(std::string fileName)
         state = checkState(fileName, &fso);
 
         fuid = fso.getfuid();
+        fileHandle = fso.getFileHandle();
         stmt(Migration::ADD_JOB) << DataBase::MIGRATION << fileName << reqNumber
                 << targetState << statbuf.st_size << fuid.fsid_h << fuid.fsid_l
                 << fuid.igen << fuid.inum << statbuf.st_mtim.tv_sec
-                << statbuf.st_mtim.tv_nsec << time(NULL) << state;
+                << statbuf.st_mtim.tv_nsec << time(NULL) << state << fileHandle;
         requestSize += fso.stat().st_size;
     } catch (const std::exception& e) {
         MSG(LTFSDMS0077E, fileName);
@@ -438,7 +450,7 @@ void Migration::addJob(std::string fileName)
         stmt(Migration::ADD_JOB) << DataBase::MIGRATION << fileName << reqNumber
                 << targetState << Const::UNSET << Const::UNSET << Const::UNSET
                 << Const::UNSET << Const::UNSET << 0 << 0 << time(NULL)
-                << FsObj::FAILED;
+                << FsObj::FAILED << "";
     }
 
     replNum = Const::UNSET;
@@ -503,6 +515,7 @@ void Migration::addRequest()
         if (needsTape) {
             Scheduler::invoke();
         } else {
+            reqCounter.begin();
             swq.enqueue(reqNumber,
                     Migration(getpid(), reqNumber, { }, numReplica,
                             targetState), replNum, "", pool, "", needsTape);
@@ -520,15 +533,21 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
 {
     struct stat statbuf, statbuf_changed;
     std::string tapeName;
-    char buffer[Const::READ_BUFFER_SIZE];
+    char *buffer;
     long rsize;
     long wsize;
+    int werrno;
     int fd = -1;
     long offset = 0;
+    long startBlock;
     bool failed = false;
+    std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration =
+            std::chrono::steady_clock::duration::zero();
 
     try {
-        FsObj source(mig_info.fileName);
+        FsObj source(mig_info.fileName, mig_info.fileHandle);
 
         TRACE(Trace::always, mig_info.fileName);
 
@@ -565,10 +584,9 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
         }
 
         {
-            std::lock_guard<std::mutex> writelock(
-                    *inventory->getDrive(driveId)->mtx);
+            std::lock_guard<std::mutex> writelock(*drive->mtx);
 
-            if (inventory->getDrive(driveId)->getToUnblock()
+            if (drive->getToUnblock()
                     < DataBase::MIGRATION) {
                 TRACE(Trace::always, mig_info.fileName, tapeId);
                 std::lock_guard<std::mutex> lock(Migration::pmigmtx);
@@ -576,24 +594,29 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
                 THROW(Error::OK);
             }
 
+            ChunkReader reader(source, statbuf.st_size,
+                    inventory->getBlockSize());
+
             while (offset < statbuf.st_size) {
                 if (Server::forcedTerminate)
                     THROW(Error::OK);
 
-                rsize = source.read(offset,
-                        statbuf.st_size - offset > Const::READ_BUFFER_SIZE ?
-                                Const::READ_BUFFER_SIZE :
-                                statbuf.st_size - offset, buffer);
-                if (rsize == -1) {
+                rsize = reader.next(&buffer);
+                if (rsize <= 0) {
                     TRACE(Trace::error, errno);
                     MSG(LTFSDMS0023E, mig_info.fileName);
                     THROW(Error::GENERAL_ERROR, errno, mig_info.fileName);
                 }
 
+                start = std::chrono::steady_clock::now();
                 wsize = write(fd, buffer, rsize);
+                werrno = errno;
+                duration += std::chrono::steady_clock::now() - start;
 
                 if (wsize != rsize) {
-                    TRACE(Trace::error, errno, wsize, rsize);
+                    TRACE(Trace::error, werrno, wsize, rsize);
+                    if (wsize == -1 && werrno != ENOSPC)
+                        drive->addError();
                     MSG(LTFSDMS0022E, tapeName.c_str());
                     THROW(Error::GENERAL_ERROR, mig_info.fileName, wsize,
                             rsize);
@@ -616,6 +639,8 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
             }
         }
 
+        drive->addTransfer(LTFSDMDrive::WRITE, statbuf.st_size, duration);
+
         if (fsetxattr(fd, Const::LTFS_ATTR.c_str(), mig_info.fileName.c_str(),
                 mig_info.fileName.length(), 0) == -1) {
             TRACE(Trace::error, errno);
@@ -628,7 +653,13 @@ unsigned long Migration::transferData(std::string tapeId, std::string driveId,
         mrStatus.updateSuccess(mig_info.reqNumber, mig_info.fromState,
                 mig_info.toState);
 
-        source.addTapeAttr(tapeId, Server::getStartBlock(tapeName, fd));
+        inventory->getCartridge(tapeId)->reduceRemainingCap(statbuf.st_size);
+
+        startBlock = Server::getStartBlock(tapeName, fd);
+        source.addTapeAttr(tapeId, startBlock);
+
+        Catalog::add(tapeId, startBlock, source.getfuid(), mig_info.fileName,
+                statbuf.st_size);
 
         std::lock_guard<std::mutex> lock(Migration::pmigmtx);
         inumList->push_back(mig_info.inum);
@@ -665,23 +696,24 @@ void Migration::changeFileState(Migration::mig_info_t mig_info,
 
 {
     try {
-        FsObj source(mig_info.fileName);
+        FsObj source(mig_info.fileName, mig_info.fileHandle);
         FsObj::mig_target_attr_t attr;
+        FsObj::file_state state;
 
         TRACE(Trace::always, mig_info.fileName);
 
         std::lock_guard<FsObj> fsolock(source);
         attr = source.getAttribute();
+        state = source.getMigState();
 
-        TRACE(Trace::always, mig_info.fileName, source.getMigState());
+        TRACE(Trace::always, mig_info.fileName, state);
 
         // file already migrated
-        if (source.getMigState() == FsObj::MIGRATED)
+        if (state == FsObj::MIGRATED)
             return;
 
         // file already premigrated
-        if (source.getMigState() == FsObj::PREMIGRATED
-                && toState == FsObj::PREMIGRATED)
+        if (state == FsObj::PREMIGRATED && toState == FsObj::PREMIGRATED)
             return;
 
         // if not all replicas are completed
@@ -693,11 +725,12 @@ void Migration::changeFileState(Migration::mig_info_t mig_info,
         if (toState == FsObj::MIGRATED) {
             source.prepareStubbing();
             source.stub();
+            Catalog::setState(source.getfuid(), FsObj::MIGRATED);
         } else {
             source.finishPremigration();
         }
 
-        std::lock_guard<std::mutex> lock(Migration::pmigmtx);
+        // the list belongs to the caller, no lock required
         inumList->push_back(mig_info.inum);
     } catch (const std::exception& e) {
         TRACE(Trace::error, e.what());
@@ -718,12 +751,33 @@ void Migration::changeFileState(Migration::mig_info_t mig_info,
                 mig_info.toState);
 }
 
+void Migration::changeFileStates(
+        std::shared_ptr<std::list<Migration::mig_info_t>> migInfos,
+        std::shared_ptr<std::list<unsigned long>> inumList,
+        FsObj::file_state toState)
+
+{
+    std::shared_ptr<std::list<unsigned long>> batchInums = std::make_shared<
+            std::list<unsigned long>>();
+
+    TRACE(Trace::normal, migInfos->size());
+
+    for (Migration::mig_info_t mig_info : *migInfos)
+        changeFileState(mig_info, batchInums, toState);
+
+    Catalog::flush();
+
+    std::lock_guard<std::mutex> lock(Migration::pmigmtx);
+    inumList->splice(inumList->end(), *batchInums);
+}
+
 Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
         FsObj::file_state fromState, FsObj::file_state toState)
 
 {
     SQLStatement stmt;
     std::string fileName;
+    std::string fileHandle;
     Migration::req_return_t retval = (Migration::req_return_t ) { false, false };
     time_t start;
     long secs;
@@ -733,6 +787,8 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
     std::shared_ptr<std::list<unsigned long>> inumList = std::make_shared<
             std::list<unsigned long>>();
     std::shared_ptr<bool> suspended = std::make_shared<bool>(false);
+    std::shared_ptr<std::list<Migration::mig_info_t>> migInfos =
+            std::make_shared<std::list<Migration::mig_info_t>>();
     unsigned long freeSpace = 0;
     int num_found = 0;
     int total = 0;
@@ -763,9 +819,7 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
                     FsObj::TRANSFERRING : FsObj::CHANGINGFSTATE);
 
     if (toState == FsObj::TRANSFERRED) {
-        freeSpace =
-                1024 * 1024
-                        * inventory->getCartridge(tapeId)->get_le()->get_remaining_cap();
+        freeSpace = inventory->getCartridge(tapeId)->getRemainingCap();
         stmt(Migration::SET_TRANSFERRING) << newState << tapeId << reqNumber
                 << fromState << replNum << (unsigned long) &freeSpace
                 << (unsigned long) &num_found << (unsigned long) &total;
@@ -785,13 +839,13 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
     TRACE(Trace::normal, stmt.str());
     stmt.prepare();
     start = time(NULL);
-    while (stmt.step(&fileName, &secs, &nsecs, &inum)) {
+    while (stmt.step(&fileName, &secs, &nsecs, &inum, &fileHandle)) {
         if (Server::terminate == true)
             break;
 
         try {
             Migration::mig_info_t mig_info = { fileName, reqNumber, numReplica,
-                    replNum, inum, "", fromState, toState };
+                    replNum, inum, "", fromState, toState, fileHandle };
 
             TRACE(Trace::always, fileName, reqNumber);
 
@@ -805,7 +859,13 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
                         drive->get_le()->GetObjectID(), secs, nsecs, mig_info,
                         inumList, suspended);
             } else {
-                Server::wqs->enqueue(reqNumber, mig_info, inumList, toState);
+                migInfos->push_back(mig_info);
+                if (migInfos->size() >= Const::STUBBING_BATCH_SIZE) {
+                    Server::wqs->enqueue(reqNumber, migInfos, inumList,
+                            toState);
+                    migInfos = std::make_shared<
+                            std::list<Migration::mig_info_t>>();
+                }
             }
         } catch (const std::exception& e) {
             TRACE(Trace::error, e.what());
@@ -828,8 +888,12 @@ Migration::req_return_t Migration::processFiles(int replNum, std::string tapeId,
     }
     stmt.finalize();
 
+    if (migInfos->size() > 0)
+        Server::wqs->enqueue(reqNumber, migInfos, inumList, toState);
+
     if (toState == FsObj::TRANSFERRED) {
         drive->wqp->waitCompletion(reqNumber);
+        Catalog::flush();
     } else {
         Server::wqs->waitCompletion(reqNumber);
     }
@@ -872,6 +936,7 @@ void Migration::execRequest(int replNum, std::string driveId, std::string pool,
 {
     TRACE(Trace::full, __PRETTY_FUNCTION__);
 
+    RequestCounter::Guard guard;
     SQLStatement stmt;
     Migration::req_return_t retval = (Migration::req_return_t ) { false, false };
     bool failed = false;
@@ -908,7 +973,7 @@ void Migration::execRequest(int replNum, std::string driveId, std::string pool,
         }
 
         {
-            inventory->update(inventory->getCartridge(tapeId));
+            inventory->updateCartridgeAsync(tapeId);
 
             std::lock_guard<std::recursive_mutex> lock(LTFSDMInventory::mtx);
             if (inventory->getCartridge(tapeId)->getState()
@@ -64,6 +64,7 @@ public:
         std::string poolName;
         FsObj::file_state fromState;
         FsObj::file_state toState;
+        std::string fileHandle;
     };
     static std::mutex pmigmtx;
 
@@ -74,6 +75,10 @@ public:
     static void changeFileState(mig_info_t mig_info,
             std::shared_ptr<std::list<unsigned long>> inumList,
             FsObj::file_state toState);
+    static void changeFileStates(
+            std::shared_ptr<std::list<mig_info_t>> migInfos,
+            std::shared_ptr<std::list<unsigned long>> inumList,
+            FsObj::file_state toState);
 
     Migration(unsigned long _pid, long _reqNumber, std::set<std::string> _pools,
             int _numReplica, int _targetState) :
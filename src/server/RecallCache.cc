@@ -0,0 +1,342 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page recall_cache Recall Cache
+
+    # RecallCache
+
+    A transparent recall that has been triggered by a read access leaves
+    the file in premigrated state. Without further action such a file would
+    occupy disk space until it is migrated again by an operator. The
+    RecallCache keeps track of these files and re-stubs the least recently
+    used ones if the premigrated data of a single file system exceeds its
+    limit. The limit defaults to Const::RECALL_CACHE_SIZE and can be set
+    for each managed file system by a line of the following format within
+    the configuration file:
+
+    @verbatim
+    recallcache: <mount point> <size in bytes>
+    @endverbatim
+
+    - TransRecall::processFiles adds a file by calling RecallCache::add
+      after it has been recalled to premigrated state. Files for which
+      the connector does not provide a file name are not tracked since
+      they cannot be addressed for stubbing.
+    - RecallCache::run is started by Server::run as an additional thread.
+      It periodically checks all file systems and calls RecallCache::shrink
+      for those that exceed the limit.
+    - The list is not persisted. After TransRecall::manageFs has managed a
+      file system it calls RecallCache::addFs. The RecallCache thread then
+      traverses that file system and adds all premigrated files ordered by
+      their access time (RecallCache::rebuild). This includes files that
+      have been premigrated by a migration request.
+    - Before a file is re-stubbed its access time is compared with the time
+      the file has been recorded. If it has been accessed in the meantime
+      it is moved to the head of the list instead (second chance).
+    - Files that have been changed or migrated otherwise are not in
+      premigrated state anymore and just get removed from the cache.
+    - Re-stubbing happens by Migration::changeFileState. Since the data
+      already is on tape no tape needs to be mounted.
+
+ */
+
+RecallCache recallCache;
+std::map<fuid_t, RecallCache::cache_entry_t> *RecallCache::scanned = nullptr;
+
+RecallCache::fs_cache_t& RecallCache::getFsCache(fuid_t fuid,
+        std::string fileName)
+
+{
+    fs_cache_t& fsCache = fsCaches[std::make_pair(fuid.fsid_h, fuid.fsid_l)];
+
+    if (fsCache.target.compare("") != 0)
+        return fsCache;
+
+    for (std::string fs : Server::conf.getFss()) {
+        if (fs.size() > fsCache.target.size()
+                && fileName.compare(0, fs.size(), fs) == 0
+                && fileName.size() > fs.size() && fileName[fs.size()] == '/')
+            fsCache.target = fs;
+    }
+
+    if (fsCache.target.compare("") != 0)
+        fsCache.limit = Server::conf.getRecallCacheSize(fsCache.target);
+
+    TRACE(Trace::always, fsCache.target, fsCache.limit);
+
+    return fsCache;
+}
+
+void RecallCache::add(Connector::rec_info_t recinfo, unsigned long size)
+
+{
+    std::map<fuid_t, std::list<cache_entry_t>::iterator>::iterator it;
+
+    if (recinfo.filename.compare("") == 0) {
+        TRACE(Trace::normal, recinfo.fuid.inum);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    fs_cache_t& fsCache = getFsCache(recinfo.fuid, recinfo.filename);
+
+    if ((it = fsCache.index.find(recinfo.fuid)) != fsCache.index.end())
+        remove(fsCache, it->second);
+
+    fsCache.lru.push_front(
+            (cache_entry_t ) { recinfo.filename, recinfo.fuid, size, time(
+                    NULL) });
+    fsCache.index[recinfo.fuid] = fsCache.lru.begin();
+    fsCache.size += size;
+
+    TRACE(Trace::always, recinfo.filename, size, fsCache.size);
+
+    if (fsCache.size > fsCache.limit)
+        cond.notify_one();
+}
+
+void RecallCache::addFs(std::string fs)
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    newFss.push_back(fs);
+    cond.notify_one();
+}
+
+int RecallCache::addFile(const char *fpath, const struct stat *sb,
+        int typeflag, struct FTW *ftwbuf)
+
+{
+    if (Server::terminate == true)
+        return 1;
+
+    if (typeflag != FTW_F || !S_ISREG(sb->st_mode))
+        return 0;
+
+    try {
+        FsObj fso(fpath);
+
+        if (fso.getMigState() != FsObj::PREMIGRATED)
+            return 0;
+
+        fuid_t fuid = fso.getfuid();
+        (*scanned)[fuid] = (cache_entry_t ) { fpath, fuid,
+                        (unsigned long) sb->st_size, sb->st_atime };
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, fpath, e.what());
+    }
+
+    return 0;
+}
+
+void RecallCache::rebuild(std::string fs)
+
+{
+    std::map<fuid_t, cache_entry_t> files;
+    std::vector<cache_entry_t> entries;
+    int numFiles = 0;
+    unsigned long size = 0;
+
+    TRACE(Trace::always, fs);
+
+    scanned = &files;
+    if (nftw(fs.c_str(), RecallCache::addFile, Const::RECALL_CACHE_OPEN_FDS,
+            FTW_PHYS | FTW_MOUNT) == -1) {
+        MSG(LTFSDMS0131E, fs, errno);
+        scanned = nullptr;
+        return;
+    }
+    scanned = nullptr;
+
+    for (std::pair<fuid_t, cache_entry_t> file : files)
+        entries.push_back(file.second);
+
+    // most recently accessed files first
+    std::sort(entries.begin(), entries.end(),
+            [](const cache_entry_t& a, const cache_entry_t& b) {
+                return a.lastAccess > b.lastAccess;
+            });
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    // files recalled during the traversal are kept at the head of the list
+    for (cache_entry_t& entry : entries) {
+        fs_cache_t& fsCache = getFsCache(entry.fuid, entry.fileName);
+        if (fsCache.index.find(entry.fuid) != fsCache.index.end())
+            continue;
+        fsCache.lru.push_back(entry);
+        fsCache.index[entry.fuid] = std::prev(fsCache.lru.end());
+        fsCache.size += entry.size;
+        numFiles++;
+        size += entry.size;
+    }
+
+    MSG(LTFSDMS0135I, numFiles, size, fs);
+}
+
+void RecallCache::remove(fs_cache_t& fsCache,
+        std::list<cache_entry_t>::iterator it)
+
+{
+    fsCache.size -= it->size;
+    fsCache.index.erase(it->fuid);
+    fsCache.lru.erase(it);
+}
+
+RecallCache::expire_result_t RecallCache::expire(int reqNum,
+        cache_entry_t& entry)
+
+{
+    Migration::mig_info_t miginfo;
+    std::shared_ptr<std::list<unsigned long>> inumList = std::make_shared<
+            std::list<unsigned long>>();
+    struct stat statbuf;
+
+    try {
+        FsObj fso(entry.fileName);
+
+        if (fso.getfuid() != entry.fuid) {
+            TRACE(Trace::always, entry.fileName, entry.fuid.inum);
+            return RecallCache::DROPPED;
+        }
+
+        if (fso.getMigState() != FsObj::PREMIGRATED) {
+            TRACE(Trace::always, entry.fileName, fso.getMigState());
+            return RecallCache::DROPPED;
+        }
+
+        statbuf = fso.stat();
+        if (statbuf.st_atime > entry.lastAccess) {
+            TRACE(Trace::always, entry.fileName, statbuf.st_atime,
+                    entry.lastAccess);
+            entry.lastAccess = statbuf.st_atime;
+            return RecallCache::ACCESSED;
+        }
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, entry.fileName, e.what());
+        return RecallCache::DROPPED;
+    }
+
+    miginfo.fileName = entry.fileName;
+    miginfo.reqNumber = reqNum;
+    miginfo.numRepl = 0;
+    miginfo.replNum = 0;
+    miginfo.inum = entry.fuid.inum;
+    miginfo.poolName = "";
+    miginfo.fromState = FsObj::PREMIGRATED;
+    miginfo.toState = FsObj::MIGRATED;
+
+    Migration::changeFileState(miginfo, inumList, FsObj::MIGRATED);
+
+    if (inumList->size() == 0)
+        return RecallCache::DROPPED;
+
+    return RecallCache::RESTUBBED;
+}
+
+void RecallCache::shrink(fs_cache_t& fsCache,
+        std::unique_lock<std::mutex>& lock)
+
+{
+    std::map<fuid_t, std::list<cache_entry_t>::iterator>::iterator it;
+    int reqNum = ++globalReqNumber;
+    int numFiles = 0;
+    unsigned long released = 0;
+    expire_result_t result;
+
+    TRACE(Trace::always, reqNum, fsCache.size);
+
+    mrStatus.add(reqNum);
+
+    while (fsCache.size > fsCache.limit && fsCache.lru.size() > 0
+            && Server::terminate == false) {
+        cache_entry_t entry = fsCache.lru.back();
+
+        // all remaining files have been recalled even more recently
+        if (time(NULL) - entry.lastAccess < Const::RECALL_CACHE_MIN_AGE)
+            break;
+
+        lock.unlock();
+        result = expire(reqNum, entry);
+        lock.lock();
+
+        // the file may have been recalled again in the meantime
+        if ((it = fsCache.index.find(entry.fuid)) == fsCache.index.end())
+            continue;
+
+        switch (result) {
+            case RecallCache::ACCESSED:
+                it->second->lastAccess = entry.lastAccess;
+                fsCache.lru.splice(fsCache.lru.begin(), fsCache.lru,
+                        it->second);
+                break;
+            case RecallCache::RESTUBBED:
+                numFiles++;
+                released += entry.size;
+                remove(fsCache, it->second);
+                break;
+            default:
+                remove(fsCache, it->second);
+        }
+    }
+
+    mrStatus.remove(reqNum);
+
+    if (numFiles > 0)
+        MSG(LTFSDMS0118I, numFiles, released);
+}
+
+void RecallCache::invoke()
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    cond.notify_one();
+}
+
+void RecallCache::run()
+
+{
+    std::unique_lock<std::mutex> lock(mtx);
+
+    TRACE(Trace::normal, __PRETTY_FUNCTION__);
+
+    while (Server::terminate == false) {
+        cond.wait_for(lock,
+                std::chrono::seconds(Const::RECALL_CACHE_INTERVAL));
+
+        if (Server::terminate == true)
+            break;
+
+        while (newFss.size() > 0 && Server::terminate == false) {
+            std::string fs = newFss.front();
+            newFss.pop_front();
+            lock.unlock();
+            rebuild(fs);
+            lock.lock();
+        }
+
+        for (std::map<std::pair<unsigned long, unsigned long>, fs_cache_t>::iterator it =
+                fsCaches.begin(); it != fsCaches.end(); ++it)
+            if (it->second.size > it->second.limit)
+                shrink(it->second, lock);
+    }
+
+    TRACE(Trace::always, (bool) Server::terminate);
+}
@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class RecallCache
+{
+private:
+    struct cache_entry_t
+    {
+        std::string fileName;
+        fuid_t fuid;
+        unsigned long size;
+        time_t lastAccess;
+    };
+    struct fs_cache_t
+    {
+        std::string target;
+        unsigned long limit = Const::RECALL_CACHE_SIZE;
+        unsigned long size = 0;
+        std::list<cache_entry_t> lru;
+        std::map<fuid_t, std::list<cache_entry_t>::iterator> index;
+    };
+    enum expire_result_t
+    {
+        RESTUBBED, ACCESSED, DROPPED
+    };
+    std::map<std::pair<unsigned long, unsigned long>, fs_cache_t> fsCaches;
+    std::list<std::string> newFss;
+    std::mutex mtx;
+    std::condition_variable cond;
+    static std::map<fuid_t, cache_entry_t> *scanned;
+
+    fs_cache_t& getFsCache(fuid_t fuid, std::string fileName);
+    static int addFile(const char *fpath, const struct stat *sb, int typeflag,
+            struct FTW *ftwbuf);
+    void rebuild(std::string fs);
+    void remove(fs_cache_t& fsCache,
+            std::list<cache_entry_t>::iterator it);
+    expire_result_t expire(int reqNum, cache_entry_t& entry);
+    void shrink(fs_cache_t& fsCache, std::unique_lock<std::mutex>& lock);
+public:
+    RecallCache()
+    {
+    }
+    void add(Connector::rec_info_t recinfo, unsigned long size);
+    void addFs(std::string fs);
+    void invoke();
+    void run();
+};
+
+extern RecallCache recallCache;
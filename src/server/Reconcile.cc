@@ -0,0 +1,364 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page reconcile Reconciliation
+
+    # Reconcile
+
+    The migration attribute of a file (see FsObj::mig_target_attr_t)
+    references the cartridges the data has been copied to. Nothing
+    guarantees that these copies still exist. A cartridge may have been
+    reformatted. On the other side, data files on tape might not be
+    referenced anymore: a file may have been deleted, or a migration
+    failed after the data was written. Such orphaned data wastes
+    cartridge capacity. A dangling reference only shows up as a recall
+    failure when the file is read.
+
+    The reconciliation compares both sides without accessing any
+    cartridge. The tape side is represented by the @ref catalog. For
+    cartridges written before the catalog existed, it needs to be rebuilt
+    first with the [ltfsdm rebuild](@ref ltfsdm_rebuild) command.
+
+    -# Reconcile::scan traverses all managed file systems. Each
+       reference of a premigrated or migrated file is added to the
+       temporary table RECONCILE. The inserts are committed every
+       Const::RECONCILE_BATCH_SIZE references. After the traversal an
+       index on the file uid is created.
+    -# Reconcile::findDangling lists the references for which there is no
+       catalog entry with the same cartridge and file uid.
+    -# Reconcile::findOrphaned lists the catalog entries that no
+       reference points to.
+    -# The temporary table is dropped.
+
+    Both lists are computed by an anti join. Each lookup uses the index
+    on the file uid of the other table. The effort therefore grows with
+    the number of files only.
+
+    The mismatches are sent to the client as they are found. If the
+    reconciliation has been started with cleanup
+    (<tt>ltfsdm reconcile -x</tt>), orphaned catalog entries are removed.
+    A file could have been migrated during the traversal. To cover
+    that case, each orphaned entry is checked again on disk before it
+    is removed. LTFS does not release the capacity of deleted files.
+    The data remains on the cartridge until it is reformatted, so no
+    tape operation is performed. Dangling references are only reported,
+    since the data cannot be recovered automatically.
+
+    The reconciliation uses a connection to the catalog of its own.
+    The temporary table is not part of the catalog file, so filling it
+    during the traversal does not lock the catalog for other updates.
+    Only the removal of orphaned entries writes to the catalog.
+
+    Only one reconciliation can run at a time.
+
+ */
+
+std::mutex Reconcile::mtx;
+Reconcile *Reconcile::current = nullptr;
+
+std::string Reconcile::mismatchStr(int type)
+
+{
+    switch (type) {
+        case Reconcile::DANGLING:
+            return ltfsdm_messages[LTFSDMX0088I];
+        case Reconcile::ORPHANED:
+            return ltfsdm_messages[LTFSDMX0089I];
+        default:
+            return "";
+    }
+}
+
+void Reconcile::add(std::string fileName)
+
+{
+    SQLStatement stmt(reconcileDB);
+    FsObj::mig_target_attr_t attr;
+    FsObj::file_state state;
+    fuid_t fuid;
+
+    try {
+        FsObj fso(fileName);
+
+        if ((state = fso.getMigState()) == FsObj::RESIDENT)
+            return;
+
+        attr = fso.getAttribute();
+        fuid = fso.getfuid();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, fileName, e.what());
+        return;
+    }
+
+    numFiles++;
+
+    for (int i = 0; i < attr.copies; i++) {
+        if (numBatch == Const::RECONCILE_BATCH_SIZE) {
+            stmt(DataBase::COMMIT_TRANSACTION);
+            stmt.doall();
+            stmt(DataBase::BEGIN_TRANSACTION);
+            stmt.doall();
+            numBatch = 0;
+        }
+
+        stmt(Reconcile::ADD_COPY) << attr.tapeInfo[i].tapeId << fuid.fsid_h
+                << fuid.fsid_l << fuid.igen << fuid.inum
+                << attr.tapeInfo[i].startBlock << fileName << state;
+        stmt.doall();
+
+        numCopies++;
+        numBatch++;
+    }
+}
+
+int Reconcile::addFile(const char *fpath, const struct stat *sb, int typeflag,
+        struct FTW *ftwbuf)
+
+{
+    if (Server::terminate == true)
+        return 1;
+
+    if (typeflag != FTW_F || !S_ISREG(sb->st_mode))
+        return 0;
+
+    current->add(fpath);
+
+    return 0;
+}
+
+void Reconcile::scan()
+
+{
+    SQLStatement stmt(reconcileDB);
+
+    stmt(Reconcile::DROP_RECONCILE);
+    stmt.doall();
+
+    stmt(Reconcile::CREATE_RECONCILE);
+    stmt.doall();
+
+    stmt(DataBase::BEGIN_TRANSACTION);
+    stmt.doall();
+
+    try {
+        for (std::string fs : Server::conf.getFss()) {
+            TRACE(Trace::always, fs);
+            if (nftw(fs.c_str(), Reconcile::addFile, Const::RECONCILE_OPEN_FDS,
+                    FTW_PHYS | FTW_MOUNT) == -1) {
+                MSG(LTFSDMS0131E, fs, errno);
+                THROW(Error::GENERAL_ERROR, errno, fs);
+            }
+            if (Server::terminate == true)
+                THROW(Error::GENERAL_ERROR);
+        }
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        stmt(DataBase::ROLLBACK_TRANSACTION);
+        stmt.doall();
+        throw;
+    }
+
+    stmt(DataBase::COMMIT_TRANSACTION);
+    stmt.doall();
+
+    stmt(Reconcile::CREATE_RECONCILE_UID);
+    stmt.doall();
+}
+
+bool Reconcile::stillOrphaned(std::string fileName, std::string tapeId,
+        fuid_t fuid)
+
+{
+    FsObj::mig_target_attr_t attr;
+
+    try {
+        FsObj fso(fileName);
+
+        if (fso.getfuid() != fuid || fso.getMigState() == FsObj::RESIDENT)
+            return true;
+
+        attr = fso.getAttribute();
+
+        for (int i = 0; i < attr.copies; i++)
+            if (tapeId.compare(attr.tapeInfo[i].tapeId) == 0)
+                return false;
+    } catch (const std::exception& e) {
+        TRACE(Trace::normal, fileName, e.what());
+    }
+
+    return true;
+}
+
+void Reconcile::send(mismatch_t type, std::string tapeId, long startBlock,
+        unsigned long size, std::string fileName)
+
+{
+    LTFSDmProtocol::LTFSDmReconcileResp *reconcileresp =
+            command->mutable_reconcileresp();
+
+    reconcileresp->set_error(static_cast<int>(Error::OK));
+    reconcileresp->set_type(mismatchStr(type));
+    reconcileresp->set_tapeid(tapeId);
+    reconcileresp->set_startblock(startBlock);
+    reconcileresp->set_filesize(size);
+    reconcileresp->set_filename(fileName);
+
+    command->send();
+}
+
+void Reconcile::findDangling()
+
+{
+    SQLStatement stmt(reconcileDB);
+    std::string tapeId;
+    long startBlock;
+    std::string fileName;
+
+    stmt(Reconcile::SELECT_DANGLING);
+
+    stmt.prepare();
+    try {
+        while (stmt.step(&tapeId, &startBlock, &fileName)) {
+            TRACE(Trace::normal, tapeId, startBlock, fileName);
+            numDangling++;
+            send(Reconcile::DANGLING, tapeId, startBlock, 0, fileName);
+        }
+    } catch (const std::exception& e) {
+        stmt.finalize();
+        throw;
+    }
+    stmt.finalize();
+}
+
+void Reconcile::findOrphaned()
+
+{
+    SQLStatement stmt(reconcileDB);
+    std::string tapeId;
+    long startBlock;
+    unsigned long size;
+    std::string fileName;
+    fuid_t fuid;
+    std::list<orphan_t> orphans;
+
+    stmt(Reconcile::SELECT_ORPHANED);
+
+    stmt.prepare();
+    try {
+        while (stmt.step(&tapeId, &startBlock, &size, &fileName, &fuid.fsid_h,
+                &fuid.fsid_l, &fuid.igen, &fuid.inum)) {
+            if (cleanup && !stillOrphaned(fileName, tapeId, fuid))
+                continue;
+            TRACE(Trace::normal, tapeId, startBlock, fileName);
+            numOrphaned++;
+            orphanedSize += size;
+            send(Reconcile::ORPHANED, tapeId, startBlock, size, fileName);
+            if (cleanup)
+                orphans.push_back((orphan_t ) { tapeId, startBlock });
+        }
+    } catch (const std::exception& e) {
+        stmt.finalize();
+        throw;
+    }
+    stmt.finalize();
+
+    if (orphans.size() == 0)
+        return;
+
+    numBatch = 0;
+    stmt(DataBase::BEGIN_TRANSACTION);
+    stmt.doall();
+
+    for (orphan_t orphan : orphans) {
+        if (numBatch == Const::RECONCILE_BATCH_SIZE) {
+            stmt(DataBase::COMMIT_TRANSACTION);
+            stmt.doall();
+            stmt(DataBase::BEGIN_TRANSACTION);
+            stmt.doall();
+            numBatch = 0;
+        }
+        stmt(Reconcile::REMOVE_ORPHANED) << orphan.tapeId << orphan.startBlock;
+        stmt.doall();
+        numBatch++;
+    }
+
+    stmt(DataBase::COMMIT_TRANSACTION);
+    stmt.doall();
+}
+
+void Reconcile::run()
+
+{
+    SQLStatement stmt(reconcileDB);
+    int error = static_cast<int>(Error::OK);
+    std::chrono::time_point<std::chrono::steady_clock> start =
+            std::chrono::steady_clock::now();
+
+    TRACE(Trace::always, cleanup);
+
+    if (Catalog::isAvailable() == false) {
+        error = static_cast<int>(Error::GENERAL_ERROR);
+    } else {
+        std::lock_guard<std::mutex> lock(Reconcile::mtx);
+
+        Catalog::flush();
+
+        current = this;
+
+        try {
+            reconcileDB.open(Const::CATALOG_FILE);
+            scan();
+            findDangling();
+            findOrphaned();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+            error = static_cast<int>(Error::GENERAL_ERROR);
+        }
+
+        current = nullptr;
+
+        try {
+            stmt(Reconcile::DROP_RECONCILE);
+            stmt.doall();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+        }
+
+        MSG(LTFSDMS0130I, numFiles, numCopies, numDangling, numOrphaned,
+                orphanedSize,
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start).count());
+    }
+
+    LTFSDmProtocol::LTFSDmReconcileResp *reconcileresp =
+            command->mutable_reconcileresp();
+
+    reconcileresp->set_error(error);
+    reconcileresp->set_type("");
+    reconcileresp->set_tapeid("");
+    reconcileresp->set_startblock(Const::UNSET);
+    reconcileresp->set_filesize(0);
+    reconcileresp->set_filename("");
+
+    try {
+        command->send();
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+        MSG(LTFSDMS0007E);
+    }
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class Reconcile
+{
+public:
+    enum mismatch_t
+    {
+        DANGLING, /**< 0 */
+        ORPHANED /**< 1 */
+    };
+private:
+    static const std::string CREATE_RECONCILE;
+    static const std::string CREATE_RECONCILE_UID;
+    static const std::string ADD_COPY;
+    static const std::string SELECT_DANGLING;
+    static const std::string SELECT_ORPHANED;
+    static const std::string REMOVE_ORPHANED;
+    static const std::string DROP_RECONCILE;
+    static std::mutex mtx;
+    static Reconcile *current;
+    DataBase reconcileDB;
+    LTFSDmCommServer *command;
+    bool cleanup;
+    long numFiles;
+    long numCopies;
+    long numBatch;
+    long numDangling;
+    long numOrphaned;
+    unsigned long orphanedSize;
+    struct orphan_t
+    {
+        std::string tapeId;
+        long startBlock;
+    };
+
+    static int addFile(const char *fpath, const struct stat *sb, int typeflag,
+            struct FTW *ftwbuf);
+    void add(std::string fileName);
+    void scan();
+    bool stillOrphaned(std::string fileName, std::string tapeId,
+            fuid_t fuid);
+    void send(mismatch_t type, std::string tapeId, long startBlock,
+            unsigned long size, std::string fileName);
+    void findDangling();
+    void findOrphaned();
+public:
+    Reconcile(LTFSDmCommServer *command_, bool cleanup_) :
+            command(command_), cleanup(cleanup_), numFiles(0), numCopies(0), numBatch(
+                    0), numDangling(0), numOrphaned(0), orphanedSize(0)
+    {
+    }
+    void run();
+    static std::string mismatchStr(int type);
+};
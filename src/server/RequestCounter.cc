@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page request_counter Request Counter
+
+    # RequestCounter
+
+    To stop the backend it is necessary to wait for the requests that are
+    in progress and - if the queue should be drained - also for the requests
+    that have not been scheduled so far. The RequestCounter keeps both
+    numbers in memory:
+
+    - The Scheduler calls RequestCounter::begin for each request it
+      dispatches. The same happens if a request is executed without a tape
+      (Migration::addRequest, SelRecall::addRequest).
+    - Each execRequest method (Migration::execRequest, SelRecall::execRequest,
+      TransRecall::execRequest, TapeMover::execRequest,
+      TapeHandler::execRequest) holds a RequestCounter::Guard object that
+      reduces the number of requests in progress when it returns.
+    - Scheduler::invoke marks the number of queued requests as outdated.
+      At the end of each scheduling pass the Scheduler provides the number
+      of requests it was not able to schedule by RequestCounter::setQueued.
+
+    The MessageParser::stopMessage method calls RequestCounter::wait to
+    receive changes of these numbers that are forwarded to the stop command.
+
+ */
+
+RequestCounter reqCounter;
+
+RequestCounter::Guard::~Guard()
+
+{
+    reqCounter.end();
+}
+
+void RequestCounter::begin()
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    inProgress++;
+    TRACE(Trace::full, inProgress);
+}
+
+void RequestCounter::end()
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    inProgress--;
+    TRACE(Trace::full, inProgress);
+    cond.notify_all();
+}
+
+void RequestCounter::setRescan()
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    rescan = true;
+}
+
+void RequestCounter::setQueued(long num)
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    queued = num;
+    rescan = false;
+    TRACE(Trace::full, queued);
+    cond.notify_all();
+}
+
+void RequestCounter::invoke()
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    cond.notify_all();
+}
+
+/*
+ * If the backend is terminating only the requests in progress are
+ * considered since queued requests will not be scheduled anymore.
+ * Otherwise the backend is draining and also the queued requests need
+ * to be processed.
+ */
+bool RequestCounter::drained()
+
+{
+    if (Server::forcedTerminate || Server::finishTerminate)
+        return true;
+    else if (Server::terminate)
+        return inProgress == 0;
+    else
+        return inProgress == 0 && queued == 0 && rescan == false;
+}
+
+/*
+ * Waits until the numbers differ from the ones provided or until there
+ * are no outstanding requests anymore.
+ */
+bool RequestCounter::wait(long *numQueued, long *numInProgress)
+
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    bool done;
+
+    cond.wait(lock,
+            [this, numQueued, numInProgress] {return (drained() == true) || (queued != *numQueued) || (inProgress != *numInProgress);});
+
+    done = drained();
+    *numQueued = queued;
+    *numInProgress = inProgress;
+
+    TRACE(Trace::normal, queued, inProgress, done);
+
+    return done;
+}
@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+/**
+    @brief Keeps track of the number of outstanding requests.
+
+    @details
+    Requests that are being executed are counted by RequestCounter::begin
+    when they are dispatched. The count is reduced if a RequestCounter::Guard
+    object within the corresponding execRequest method goes out of scope.
+    The number of requests that are waiting to be scheduled is provided by
+    the Scheduler at the end of each scheduling pass.
+
+    RequestCounter::wait is used by the stop command to wait for changes of
+    these numbers without querying the REQUEST_QUEUE table.
+ */
+class RequestCounter
+{
+private:
+    std::mutex mtx;
+    std::condition_variable cond;
+    long queued;
+    long inProgress;
+    bool rescan;
+    bool drained();
+public:
+    class Guard
+    {
+    public:
+        Guard()
+        {
+        }
+        ~Guard();
+    };
+
+    RequestCounter() :
+            queued(0), inProgress(0), rescan(false)
+    {
+    }
+    void begin();
+    void end();
+    void setRescan();
+    void setQueued(long num);
+    void invoke();
+    bool wait(long *numQueued, long *numInProgress);
+};
+
+extern RequestCounter reqCounter;
@@ -60,6 +60,7 @@
     FILE_STATE | INT | file state: see FsObj::file_state
     START_BLOCK | INT | starting block of the data on tape of a (pre)migrated file
     CONN_INFO | BIGINT | address of connector specific information
+    FILE_HANDLE | VARCHAR | connector specific handle to reopen a file without a path lookup, see FsObj::getFileHandle
 
     ## REQUEST_QUEUE
 
@@ -100,6 +101,7 @@ const std::string DataBase::CREATE_JOB_QUEUE =
                 " FILE_STATE INT NOT NULL,"
                 " START_BLOCK INT,"
                 " CONN_INFO BIGINT,"
+                " FILE_HANDLE VARCHAR,"
                 " CONSTRAINT JOB_QUEUE_UNIQUE_FILE_NAME UNIQUE (FILE_NAME, REPL_NUM),"
                 " CONSTRAINT JOB_QUEUE_UNIQUE_UID UNIQUE (FS_ID_H, FS_ID_L, I_GEN, I_NUM, REPL_NUM))";
 
@@ -117,6 +119,146 @@ const std::string DataBase::CREATE_REQUEST_QUEUE =
                 " STATE INT NOT NULL,"
                 " CONSTRAINT REQUEST_QUEUE_UNIQUE UNIQUE(REQ_NUM, REPL_NUM, TAPE_POOL, TAPE_ID))";
 
+const std::string DataBase::BEGIN_TRANSACTION = "BEGIN TRANSACTION";
+
+const std::string DataBase::COMMIT_TRANSACTION = "COMMIT TRANSACTION";
+
+const std::string DataBase::ROLLBACK_TRANSACTION = "ROLLBACK TRANSACTION";
+
+const std::string DataBase::SET_WAL_MODE = "PRAGMA journal_mode=WAL";
+
+const std::string DataBase::SET_SYNCHRONOUS_NORMAL = "PRAGMA synchronous=NORMAL";
+
+/* ======== Catalog ======== */
+
+const std::string Catalog::CREATE_TAPE_FILES =
+        "CREATE TABLE IF NOT EXISTS TAPE_FILES("
+                " TAPE_ID CHAR(9) NOT NULL,"
+                " START_BLOCK BIGINT NOT NULL,"
+                " FS_ID_H BIGINT NOT NULL,"
+                " FS_ID_L BIGINT NOT NULL,"
+                " I_GEN INT NOT NULL,"
+                " I_NUM BIGINT NOT NULL,"
+                " FILE_NAME CHAR(4096),"
+                " FILE_SIZE BIGINT NOT NULL,"
+                " FILE_STATE INT NOT NULL,"
+                " PRIMARY KEY (TAPE_ID, START_BLOCK)) WITHOUT ROWID";
+
+const std::string Catalog::CREATE_TAPE_FILES_UID =
+        "CREATE INDEX IF NOT EXISTS TAPE_FILES_UID"
+                " ON TAPE_FILES (FS_ID_H, FS_ID_L, I_GEN, I_NUM)";
+
+const std::string Catalog::ADD_FILE =
+        "INSERT OR REPLACE INTO TAPE_FILES (TAPE_ID, START_BLOCK,"
+                " FS_ID_H, FS_ID_L, I_GEN, I_NUM, FILE_NAME, FILE_SIZE, FILE_STATE)"
+                " VALUES (" /* TAPE_ID */"'%1%', " /* START_BLOCK */"%2%, "
+                /* FS_ID_H */"%3%, " /* FS_ID_L */"%4%, " /* I_GEN */"%5%, "
+                /* I_NUM */"%6%, " /* FILE_NAME */"'%7%', " /* FILE_SIZE */"%8%, "
+                /* FILE_STATE */"%9%)";
+
+const std::string Catalog::SET_FILE_STATE =
+        "UPDATE TAPE_FILES SET FILE_STATE=%1%"
+                " WHERE FS_ID_H=%2%"
+                " AND FS_ID_L=%3%"
+                " AND I_GEN=%4%"
+                " AND I_NUM=%5%";
+
+const std::string Catalog::REMOVE_TAPE =
+        "DELETE FROM TAPE_FILES WHERE TAPE_ID='%1%'";
+
+const std::string Catalog::GET_START_BLOCK =
+        "SELECT START_BLOCK FROM TAPE_FILES"
+                " WHERE TAPE_ID='%1%'"
+                " AND FS_ID_H=%2%"
+                " AND FS_ID_L=%3%"
+                " AND I_GEN=%4%"
+                " AND I_NUM=%5%";
+
+const std::string Catalog::SELECT_TAPE =
+        "SELECT START_BLOCK, FILE_SIZE, FILE_STATE, FILE_NAME,"
+                " FS_ID_H, FS_ID_L, I_GEN, I_NUM"
+                " FROM TAPE_FILES WHERE TAPE_ID='%1%'"
+                " ORDER BY START_BLOCK";
+
+const std::string Catalog::CREATE_REBUILD_FILES =
+        "CREATE TEMP TABLE REBUILD_FILES("
+                " TAPE_ID CHAR(9) NOT NULL,"
+                " START_BLOCK BIGINT NOT NULL,"
+                " FS_ID_H BIGINT NOT NULL,"
+                " FS_ID_L BIGINT NOT NULL,"
+                " I_GEN INT NOT NULL,"
+                " I_NUM BIGINT NOT NULL,"
+                " FILE_NAME CHAR(4096),"
+                " FILE_SIZE BIGINT NOT NULL,"
+                " FILE_STATE INT NOT NULL,"
+                " PRIMARY KEY (TAPE_ID, START_BLOCK)) WITHOUT ROWID";
+
+const std::string Catalog::ADD_REBUILD_FILE =
+        "INSERT OR REPLACE INTO REBUILD_FILES (TAPE_ID, START_BLOCK,"
+                " FS_ID_H, FS_ID_L, I_GEN, I_NUM, FILE_NAME, FILE_SIZE, FILE_STATE)"
+                " VALUES (" /* TAPE_ID */"'%1%', " /* START_BLOCK */"%2%, "
+                /* FS_ID_H */"%3%, " /* FS_ID_L */"%4%, " /* I_GEN */"%5%, "
+                /* I_NUM */"%6%, " /* FILE_NAME */"'%7%', " /* FILE_SIZE */"%8%, "
+                /* FILE_STATE */"%9%)";
+
+const std::string Catalog::COPY_REBUILD_FILES =
+        "INSERT OR REPLACE INTO TAPE_FILES (TAPE_ID, START_BLOCK,"
+                " FS_ID_H, FS_ID_L, I_GEN, I_NUM, FILE_NAME, FILE_SIZE, FILE_STATE)"
+                " SELECT TAPE_ID, START_BLOCK, FS_ID_H, FS_ID_L, I_GEN, I_NUM,"
+                " FILE_NAME, FILE_SIZE, FILE_STATE FROM REBUILD_FILES";
+
+/* ======== Reconcile ======== */
+
+const std::string Reconcile::CREATE_RECONCILE =
+        "CREATE TEMP TABLE RECONCILE("
+                " TAPE_ID CHAR(9) NOT NULL,"
+                " FS_ID_H BIGINT NOT NULL,"
+                " FS_ID_L BIGINT NOT NULL,"
+                " I_GEN INT NOT NULL,"
+                " I_NUM BIGINT NOT NULL,"
+                " START_BLOCK BIGINT,"
+                " FILE_NAME CHAR(4096),"
+                " FILE_STATE INT NOT NULL)";
+
+const std::string Reconcile::CREATE_RECONCILE_UID =
+        "CREATE INDEX RECONCILE_UID"
+                " ON RECONCILE (FS_ID_H, FS_ID_L, I_GEN, I_NUM)";
+
+const std::string Reconcile::ADD_COPY =
+        "INSERT INTO RECONCILE (TAPE_ID, FS_ID_H, FS_ID_L, I_GEN, I_NUM,"
+                " START_BLOCK, FILE_NAME, FILE_STATE)"
+                " VALUES (" /* TAPE_ID */"'%1%', " /* FS_ID_H */"%2%, "
+                /* FS_ID_L */"%3%, " /* I_GEN */"%4%, " /* I_NUM */"%5%, "
+                /* START_BLOCK */"%6%, " /* FILE_NAME */"'%7%', "
+                /* FILE_STATE */"%8%)";
+
+const std::string Reconcile::SELECT_DANGLING =
+        "SELECT R.TAPE_ID, R.START_BLOCK, R.FILE_NAME FROM RECONCILE R"
+                " WHERE NOT EXISTS (SELECT 1 FROM TAPE_FILES C"
+                " WHERE C.FS_ID_H=R.FS_ID_H"
+                " AND C.FS_ID_L=R.FS_ID_L"
+                " AND C.I_GEN=R.I_GEN"
+                " AND C.I_NUM=R.I_NUM"
+                " AND C.TAPE_ID=R.TAPE_ID)";
+
+const std::string Reconcile::SELECT_ORPHANED =
+        "SELECT C.TAPE_ID, C.START_BLOCK, C.FILE_SIZE, C.FILE_NAME,"
+                " C.FS_ID_H, C.FS_ID_L, C.I_GEN, C.I_NUM"
+                " FROM TAPE_FILES C"
+                " WHERE NOT EXISTS (SELECT 1 FROM RECONCILE R"
+                " WHERE R.FS_ID_H=C.FS_ID_H"
+                " AND R.FS_ID_L=C.FS_ID_L"
+                " AND R.I_GEN=C.I_GEN"
+                " AND R.I_NUM=C.I_NUM"
+                " AND R.TAPE_ID=C.TAPE_ID)";
+
+const std::string Reconcile::REMOVE_ORPHANED =
+        "DELETE FROM TAPE_FILES"
+                " WHERE TAPE_ID='%1%' AND START_BLOCK=%2%";
+
+const std::string Reconcile::DROP_RECONCILE =
+        "DROP TABLE IF EXISTS RECONCILE";
+
 /* ======== Scheduler ======== */
 
 const std::string Scheduler::SELECT_REQUEST =
@@ -150,12 +292,12 @@ const std::string Scheduler::SMALLEST_MIG_JOB =
 
 const std::string Migration::ADD_JOB =
         "INSERT INTO JOB_QUEUE (OPERATION, FILE_NAME, REQ_NUM, TARGET_STATE, REPL_NUM, TAPE_POOL,"
-                " FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN, I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, TAPE_ID, FILE_STATE)"
+                " FILE_SIZE, FS_ID_H, FS_ID_L, I_GEN, I_NUM, MTIME_SEC, MTIME_NSEC, LAST_UPD, TAPE_ID, FILE_STATE, FILE_HANDLE)"
                 " VALUES (" /* OPERATION */"%1%, " /* FILE_NAME */"'%2%', " /* REQ_NUM */"%3%, "
                 /* TARGET_STATE */"%4%, " /* REPL_NUM */"?, " /* TAPE_POOL */"?, "
                 /* FILE_SIZE */"%5%, " /* FS_ID_H */"%6%, " /* FS_ID_L */"%7%, " /* I_GEN */"%8%,"
                 /* I_NUM */"%9%, "/* MTIME_SEC */"%10%, " /* MTIME_NSEC */"%11%, " /* LAST_UPD */"%12%, "
-                /* TAPE_ID */"'', " /* FILE_STATE */"%13%)";
+                /* TAPE_ID */"'', " /* FILE_STATE */"%13%, " /* FILE_HANDLE */"'%14%')";
 
 const std::string Migration::ADD_REQUEST =
         "INSERT INTO REQUEST_QUEUE (OPERATION, REQ_NUM, TARGET_STATE,"
@@ -191,7 +333,7 @@ const std::string Migration::SET_CHANGE_STATE =
                 " AND REPL_NUM=%5%";
 
 const std::string Migration::SELECT_JOBS =
-        "SELECT FILE_NAME, MTIME_SEC, MTIME_NSEC, I_NUM FROM JOB_QUEUE WHERE"
+        "SELECT FILE_NAME, MTIME_SEC, MTIME_NSEC, I_NUM, FILE_HANDLE FROM JOB_QUEUE WHERE"
                 " REQ_NUM=%1%"
                 " AND FILE_STATE=%2%"
                 " AND TAPE_ID='%3%'";
@@ -251,6 +393,21 @@ const std::string SelRecall::SET_RECALLING =
                 " AND FILE_STATE=%3%"
                 " AND TAPE_ID='%4%'";
 
+const std::string SelRecall::GET_UNSET_BLOCKS =
+        "SELECT FS_ID_H, FS_ID_L, I_GEN, I_NUM FROM JOB_QUEUE"
+                " WHERE REQ_NUM=%1%"
+                " AND TAPE_ID='%2%'"
+                " AND START_BLOCK=%3%";
+
+const std::string SelRecall::SET_START_BLOCK =
+        "UPDATE JOB_QUEUE SET START_BLOCK=%1%"
+                " WHERE REQ_NUM=%2%"
+                " AND TAPE_ID='%3%'"
+                " AND FS_ID_H=%4%"
+                " AND FS_ID_L=%5%"
+                " AND I_GEN=%6%"
+                " AND I_NUM=%7%";
+
 //! [sel_recall_sql_qry]
 const std::string SelRecall::SELECT_JOBS =
         "SELECT FILE_NAME, FILE_STATE, I_NUM FROM JOB_QUEUE WHERE REQ_NUM=%1%"
@@ -349,9 +506,6 @@ const std::string FileOperation::DELETE_REQUESTS =
 
 /* ======== MessageParser ======== */
 
-const std::string MessageParser::ALL_REQUESTS =
-        "SELECT STATE FROM REQUEST_QUEUE";
-
 const std::string MessageParser::INFO_ALL_REQUESTS =
         "SELECT OPERATION, REQ_NUM, TAPE_ID, TARGET_STATE, STATE, TAPE_POOL"
                 " FROM REQUEST_QUEUE";
@@ -107,19 +107,29 @@
     A tape storage pool is checked for availability in the following way
     (return statements are performed in respect to the condition):
 
-    -# If a cartridge of the specified tape storage pool is mounted but not in
-       use and the remaining space is larger than the smallest file to migrate:
-       <b>return true</b>.
-    -# If there is no cartridge that is not mounted there is no need to look
-       for a cartridge from another pool to unmount: <b>return false</b>.
+    -# If a cartridge of the specified tape storage pool is mounted on a
+       drive that is not degraded but not in use and the remaining space is
+       larger than the smallest file to migrate: <b>return true</b>.
+       A cartridge that is mounted on a degraded drive is remembered.
     -# Check if there is an empty drive to mount a tape which is part of the
-       specified pool. If this is the case: <b>mount tape</b> and <b>return false</b>.
+       specified pool. Degraded drives are considered only if there is no
+       cartridge mounted on a degraded drive. If this is the case:
+       <b>mount tape</b> and <b>return false</b>.
     -# Check if a for the current request there is a tape mount/unmount already
        in progress. If this is the case: <b>return false</b>.
+    -# If a cartridge mounted on a degraded drive has been remembered:
+       <b>return true</b>.
+    -# If there is no cartridge that is not mounted there is no need to look
+       for a cartridge from another pool to unmount: <b>return false</b>.
     -# Thereafter it is checked if there is a cartridge from another pool that
        is mounted but not in use. <b>Unmount tape</b> and <b>return false</b>.
     -# <b>return false</b>
 
+    For mounting and unmounting cartridges the drives are considered in the
+    order of LTFSDMInventory::getDrivesByHealth: drives that are degraded
+    because of a low throughput or a high error rate come last (see
+    @subpage drive_performance).
+
     ## Schedule request
 
     If Scheduler::resAvail is true a request can be scheduled. Depending on
@@ -211,43 +221,53 @@ bool Scheduler::poolResAvail(unsigned long minFileSize)
 {
     bool found;
     bool unmountedExists = false;
+    std::string slowDriveId = "";
+    std::string slowTapeId = "";
+    std::shared_ptr<const ConfigSnapshot> conf = Server::conf.getSnapshot();
 
     assert(pool.compare("") != 0);
 
-    for (std::string cartname : Server::conf.getPool(pool)) {
+    for (std::string cartname : conf->getPool(pool)) {
         std::shared_ptr<LTFSDMCartridge> cart;
         if ((cart = inventory->getCartridge(cartname)) == nullptr) {
             MSG(LTFSDMX0034E, cartname);
             Server::conf.poolRemove(pool, cartname);
+            continue;
         }
         if (cart->getState() == LTFSDMCartridge::TAPE_MOUNTED) {
             tapeId = cart->get_le()->GetObjectID();
             found = false;
             for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
                 if (drive->get_le()->get_slot() == cart->get_le()->get_slot()
-                        && 1024 * 1024 * cart->get_le()->get_remaining_cap()
-                                >= minFileSize) {
+                        && cart->getRemainingCap() >= minFileSize) {
                     assert(drive->isBusy() == false);
+                    found = true;
+                    // keep it as a fallback if it is mounted on a slow drive
+                    if (drive->isDegraded()) {
+                        if (slowDriveId.compare("") == 0) {
+                            slowDriveId = drive->get_le()->GetObjectID();
+                            slowTapeId = tapeId;
+                        }
+                        break;
+                    }
                     TRACE(Trace::always, drive->get_le()->GetObjectID());
                     driveId = drive->get_le()->GetObjectID();
                     Scheduler::makeUse(driveId, tapeId);
-                    found = true;
-                    break;
+                    return true;
                 }
             }
-            assert(
-                    found == true || 1024*1024*cart->get_le()->get_remaining_cap() < minFileSize);
-            if (found == true)
-                return true;
+            assert(found == true || cart->getRemainingCap() < minFileSize);
         } else if (cart->getState() == LTFSDMCartridge::TAPE_UNMOUNTED)
             unmountedExists = true;
     }
 
-    if (unmountedExists == false)
-        return false;
-
     // check if there is an empty drive to mount a tape
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
+    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrivesByHealth()) {
+        if (unmountedExists == false)
+            break;
+        // a cartridge already is mounted on a slow drive: no other slow one
+        if (slowDriveId.compare("") != 0 && drive->isDegraded())
+            break;
         if (driveIsUsable(drive) == false)
             continue;
         found = false;
@@ -261,14 +281,14 @@ bool Scheduler::poolResAvail(unsigned long minFileSize)
         }
         if (found == false) {
             std::shared_ptr<LTFSDMCartridge> cart;
-            for (std::string cartname : Server::conf.getPool(pool)) {
+            for (std::string cartname : conf->getPool(pool)) {
                 if ((cart = inventory->getCartridge(cartname)) == nullptr) {
                     MSG(LTFSDMX0034E, cartname);
                     Server::conf.poolRemove(pool, cartname);
+                    continue;
                 }
                 if (cart->getState() == LTFSDMCartridge::TAPE_UNMOUNTED
-                        && 1024 * 1024 * cart->get_le()->get_remaining_cap()
-                                >= minFileSize) {
+                        && cart->getRemainingCap() >= minFileSize) {
                     Scheduler::moveTape(drive->get_le()->GetObjectID(),
                             cartname, Scheduler::mountTarget);
                     return false;
@@ -286,8 +306,20 @@ bool Scheduler::poolResAvail(unsigned long minFileSize)
                 && drive->getMoveReqPool().compare(pool) == 0)
             return false;
 
+    // no healthy drive available: use the slow one
+    if (slowDriveId.compare("") != 0) {
+        TRACE(Trace::always, slowDriveId, slowTapeId);
+        tapeId = slowTapeId;
+        driveId = slowDriveId;
+        Scheduler::makeUse(driveId, tapeId);
+        return true;
+    }
+
+    if (unmountedExists == false)
+        return false;
+
     // check if there is a tape to unmount
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
+    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrivesByHealth()) {
         if (driveIsUsable(drive) == false)
             continue;
         for (std::shared_ptr<LTFSDMCartridge> cart : inventory->getCartridges()) {
@@ -337,7 +369,7 @@ bool Scheduler::tapeResAvail()
     }
 
     // looking for a free drive
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
+    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrivesByHealth()) {
         if (driveIsUsable(drive) == false)
             continue;
         found = false;
@@ -359,7 +391,7 @@ bool Scheduler::tapeResAvail()
     }
 
     // looking for a tape to unmount
-    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrives()) {
+    for (std::shared_ptr<LTFSDMDrive> drive : inventory->getDrivesByHealth()) {
         if (driveIsUsable(drive) == false)
             continue;
         for (std::shared_ptr<LTFSDMCartridge> cart : inventory->getCartridges()) {
@@ -455,6 +487,7 @@ void Scheduler::invoke()
     TRACE(Trace::always, "invoke scheduler");
 
     std::unique_lock<std::mutex> lock(Scheduler::mtx);
+    reqCounter.setRescan();
     Scheduler::cond.notify_one();
 }
 
@@ -468,6 +501,7 @@ void Scheduler::run(long key)
     std::stringstream ssql;
     std::unique_lock<std::mutex> lock(mtx);
     unsigned long minFileSize;
+    long numQueued;
 
     while (true) {
         cond.wait(lock);
@@ -479,6 +513,7 @@ void Scheduler::run(long key)
 
         selstmt(Scheduler::SELECT_REQUEST) << DataBase::REQ_NEW;
 
+        numQueued = 0;
         selstmt.prepare();
         while (selstmt.step(&op, &reqNum, &tgtState, &numRepl, &replNum, &pool,
                 &tapeId, &driveId)) {
@@ -486,6 +521,8 @@ void Scheduler::run(long key)
 
             TRACE(Trace::always, op, reqNum, replNum, tapeId, driveId);
 
+            numQueued++;
+
             if (op == DataBase::MIGRATION)
                 minFileSize = smallestMigJob(reqNum, replNum);
             else
@@ -503,6 +540,9 @@ void Scheduler::run(long key)
 
             std::stringstream thrdinfo;
 
+            numQueued--;
+            reqCounter.begin();
+
             switch (op) {
                 case DataBase::MOUNT:
                 case DataBase::MOVE:
@@ -579,10 +619,12 @@ void Scheduler::run(long key)
                             TransRecall(), reqNum, driveId, tapeId);
                     break;
                 default:
+                    reqCounter.end();
                     TRACE(Trace::error, op);
             }
         }
         selstmt.finalize();
+        reqCounter.setQueued(numQueued);
     }
     MSG(LTFSDMS0081I);
     subs.waitAllRemaining();
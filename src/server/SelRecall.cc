@@ -221,6 +221,13 @@
     For an optimal performance the data should be read serially from
     tape in the order of the starting block of each data file.
 
+    The starting block normally is taken from the migration attribute
+    when the job is added. For jobs where it is not known at that time
+    SelRecall::orderByCatalog takes it from the tape catalog before the
+    jobs are selected: the catalog entries of the tape are traversed once
+    in the order of their starting block (see Catalog::TapeFiles) and the
+    START_BLOCK column of the matching jobs is updated.
+
     ### SelRecall::recall
 
     Recalling an individual file is performed according the following steps:
@@ -256,6 +263,10 @@ void SelRecall::addJob(std::string fileName)
 
         attr = fso.getAttribute();
 
+        if (attr.tapeInfo[0].startBlock == Const::UNSET)
+            attr.tapeInfo[0].startBlock = Catalog::getStartBlock(
+                    attr.tapeInfo[0].tapeId, fso.getfuid());
+
         if (state == FsObj::MIGRATED) {
             needsTape.insert(attr.tapeInfo[0].tapeId);
         }
@@ -325,6 +336,7 @@ void SelRecall::addRequest()
             Scheduler::invoke();
         } else {
             thrdinfo << "SR(" << reqNumber << ")";
+            reqCounter.begin();
             subs.enqueue(thrdinfo.str(), &SelRecall::execRequest,
                     SelRecall(getpid(), reqNumber, targetState), "", tapeId,
                     false);
@@ -337,7 +349,8 @@ void SelRecall::addRequest()
 }
 
 unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
-        FsObj::file_state state, FsObj::file_state toState)
+        std::string driveId, FsObj::file_state state,
+        FsObj::file_state toState)
 
 {
     struct stat statbuf;
@@ -348,7 +361,12 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
     long wsize;
     int fd = -1;
     long offset = 0;
+    long untimed = 0;
     FsObj::file_state curstate;
+    std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration =
+            std::chrono::steady_clock::duration::zero();
 
     try {
         FsObj target(fileName);
@@ -392,13 +410,21 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
                 if (Server::forcedTerminate)
                     THROW(Error::OK);
 
+                start = std::chrono::steady_clock::now();
                 rsize = read(fd, buffer, sizeof(buffer));
+                // the first read includes positioning to the start block
+                if (offset == 0)
+                    untimed = rsize;
+                else
+                    duration += std::chrono::steady_clock::now() - start;
                 if (rsize == 0) {
                     break;
                 }
 
                 if (rsize == -1) {
                     TRACE(Trace::error, errno);
+                    if (drive != nullptr)
+                        drive->addError();
                     MSG(LTFSDMS0023E, tapeName.c_str());
                     THROW(Error::GENERAL_ERROR, fileName, errno);
                 }
@@ -413,6 +439,9 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
             }
 
             close(fd);
+            if (drive != nullptr)
+                drive->addTransfer(LTFSDMDrive::READ, offset - untimed,
+                        duration);
         }
 
         target.finishRecall(toState);
@@ -428,6 +457,45 @@ unsigned long SelRecall::recall(std::string fileName, std::string tapeId,
     return statbuf.st_size;
 }
 
+void SelRecall::orderByCatalog(std::string tapeId)
+
+{
+    SQLStatement stmt;
+    Catalog::entry_t entry;
+    fuid_t fuid;
+    std::set<fuid_t> unset;
+
+    stmt(SelRecall::GET_UNSET_BLOCKS) << reqNumber << tapeId << Const::UNSET;
+    TRACE(Trace::normal, stmt.str());
+    stmt.prepare();
+    while (stmt.step(&fuid.fsid_h, &fuid.fsid_l, &fuid.igen, &fuid.inum))
+        unset.insert(fuid);
+    stmt.finalize();
+
+    if (unset.size() == 0 || Catalog::isAvailable() == false)
+        return;
+
+    TRACE(Trace::always, tapeId, unset.size());
+
+    try {
+        Catalog::TapeFiles files(tapeId);
+
+        while (unset.size() > 0 && files.next(&entry)) {
+            if (unset.erase(entry.fuid) == 0)
+                continue;
+            stmt(SelRecall::SET_START_BLOCK) << entry.startBlock << reqNumber
+                    << tapeId << entry.fuid.fsid_h << entry.fuid.fsid_l
+                    << entry.fuid.igen << entry.fuid.inum;
+            TRACE(Trace::full, stmt.str());
+            stmt.doall();
+        }
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+    }
+
+    TRACE(Trace::always, tapeId, unset.size());
+}
+
 bool SelRecall::processFiles(std::string tapeId, FsObj::file_state toState,
 bool needsTape)
 
@@ -437,6 +505,7 @@ bool needsTape)
     FsObj::file_state state;
     unsigned long inum;
     std::shared_ptr<LTFSDMDrive> drive = nullptr;
+    std::string driveId = "";
     std::list<unsigned long> inumList;
     bool suspended = false;
     time_t start;
@@ -458,8 +527,12 @@ bool needsTape)
             }
         }
         assert(drive != nullptr);
+        driveId = drive->get_le()->GetObjectID();
     }
 
+    if (needsTape)
+        orderByCatalog(tapeId);
+
     stmt(SelRecall::SET_RECALLING) << FsObj::RECALLING_MIG << reqNumber
             << FsObj::MIGRATED << tapeId;
     TRACE(Trace::normal, stmt.str());
@@ -500,7 +573,7 @@ bool needsTape)
                 MSG(LTFSDMS0047E, fileName);
                 THROW(Error::GENERAL_ERROR, fileName);
             }
-            recall(fileName, tapeId, state, toState);
+            recall(fileName, tapeId, driveId, state, toState);
             inumList.push_back(inum);
             mrStatus.updateSuccess(reqNumber, state, toState);
         } catch (const std::exception& e) {
@@ -552,9 +625,12 @@ void SelRecall::execRequest(std::string driveId, std::string tapeId,
 bool needsTape)
 
 {
+    RequestCounter::Guard guard;
     SQLStatement stmt;
     bool suspended = false;
 
+    Affinity::bindThreadToDrive(driveId);
+
     mrStatus.add(reqNumber);
 
     if (targetState == FsObj::PREMIGRATED)
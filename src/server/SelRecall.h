@@ -24,7 +24,9 @@ private:
     std::set<std::string> needsTape;
     int targetState;
     static unsigned long recall(std::string fileName, std::string tapeId,
-            FsObj::file_state state, FsObj::file_state toState);
+            std::string driveId, FsObj::file_state state,
+            FsObj::file_state toState);
+    void orderByCatalog(std::string tapeId);
     bool processFiles(std::string tapeId, FsObj::file_state toState,
             bool needsTape);
 
@@ -32,6 +34,8 @@ private:
     static const std::string GET_TAPES;
     static const std::string ADD_REQUEST;
     static const std::string SET_RECALLING;
+    static const std::string GET_UNSET_BLOCKS;
+    static const std::string SET_START_BLOCK;
     static const std::string SELECT_JOBS;
     static const std::string FAIL_JOB;
     static const std::string SET_JOB_SUCCESS;
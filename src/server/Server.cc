@@ -19,12 +19,13 @@
 std::atomic<bool> Server::terminate;
 std::atomic<bool> Server::forcedTerminate;
 std::atomic<bool> Server::finishTerminate;
+std::atomic<bool> Server::drainTerminate;
 std::mutex Server::termmtx;
 std::condition_variable Server::termcond;
 Configuration Server::conf;
 
-ThreadPool<Migration::mig_info_t, std::shared_ptr<std::list<unsigned long>>,
-        FsObj::file_state> *Server::wqs;
+ThreadPool<std::shared_ptr<std::list<Migration::mig_info_t>>,
+        std::shared_ptr<std::list<unsigned long>>, FsObj::file_state> *Server::wqs;
 
 int Server::statTapeRetry(std::string tapeId, const char *pathname,
         struct stat *buf)
@@ -231,21 +232,22 @@ void Server::signalHandler(sigset_t set, long key)
         TRACE(Trace::always, requestNumber);
         bool finished = false;
 
-        do {
-            LTFSDmProtocol::LTFSDmStopRequest *stopreq =
-                    commCommand.mutable_stoprequest();
-            stopreq->set_key(key);
-            stopreq->set_reqnumber(requestNumber);
-            stopreq->set_forced(false);
-            stopreq->set_finish(true);
+        LTFSDmProtocol::LTFSDmStopRequest *stopreq =
+                commCommand.mutable_stoprequest();
+        stopreq->set_key(key);
+        stopreq->set_reqnumber(requestNumber);
+        stopreq->set_forced(false);
+        stopreq->set_finish(true);
+        stopreq->set_drain(false);
 
-            try {
-                commCommand.send();
-            } catch (const std::exception& e) {
-                TRACE(Trace::error, e.what());
-                goto end;
-            }
+        try {
+            commCommand.send();
+        } catch (const std::exception& e) {
+            TRACE(Trace::error, e.what());
+            goto end;
+        }
 
+        do {
             try {
                 commCommand.recv();
             } catch (const std::exception& e) {
@@ -257,13 +259,7 @@ void Server::signalHandler(sigset_t set, long key)
                     commCommand.stopresp();
 
             finished = stopresp.success();
-
-            if (!finished) {
-                sleep(1);
-            } else {
-                break;
-            }
-        } while (true);
+        } while (!finished);
 
         if (sig == SIGUSR1)
             goto end;
@@ -351,6 +347,8 @@ void Server::initialize(bool dbUseMemory)
         MSG(LTFSDMS0014E);
         THROW(Error::GENERAL_ERROR);
     }
+
+    Catalog::open();
     //! [init db]
 }
 
@@ -402,6 +400,7 @@ void Server::run(sigset_t set)
     Server::terminate = false;
     Server::forcedTerminate = false;
     Server::finishTerminate = false;
+    Server::drainTerminate = false;
 
     //! [read the configuration file]
     try {
@@ -426,16 +425,19 @@ void Server::run(sigset_t set)
     }
 
     //! [thread pool for stubbing]
-    Server::wqs = new ThreadPool<Migration::mig_info_t,
+    Server::wqs = new ThreadPool<
+            std::shared_ptr<std::list<Migration::mig_info_t>>,
             std::shared_ptr<std::list<unsigned long>>, FsObj::file_state>(
-            &Migration::changeFileState, Const::MAX_STUBBING_THREADS,
+            &Migration::changeFileStates, Const::MAX_STUBBING_THREADS,
             "stub1-wq");
+    Server::wqs->setAffinity(Affinity::getCpus("stubbing"));
     //! [thread pool for stubbing]
 
     subs.enqueue("Scheduler", &Scheduler::run, &sched, key);
     subs.enqueue("SigHandler", &Server::signalHandler, set, key);
     subs.enqueue("Receiver", &Receiver::run, &recv, key, connector);
     subs.enqueue("RecallD", &TransRecall::run, &trec, connector);
+    subs.enqueue("RecallCache", &RecallCache::run, &recallCache);
 
     subs.waitAllRemaining();
 
@@ -446,6 +448,8 @@ void Server::run(sigset_t set)
 
     delete (Server::wqs);
 
+    Catalog::flush();
+
     end:
 
     if (inventory)
@@ -28,10 +28,11 @@ public:
     static std::atomic<bool> terminate;
     static std::atomic<bool> forcedTerminate;
     static std::atomic<bool> finishTerminate;
+    static std::atomic<bool> drainTerminate;
 
     static Configuration conf;
 
-    static ThreadPool<Migration::mig_info_t,
+    static ThreadPool<std::shared_ptr<std::list<Migration::mig_info_t>>,
             std::shared_ptr<std::list<unsigned long>>, FsObj::file_state> *wqs;
 
     static int statTapeRetry(std::string tapeId, const char *pathname,
@@ -26,9 +26,12 @@
 #include <sys/xattr.h>
 #include <sys/resource.h>
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <ftw.h>
 #include <libmount/libmount.h>
 #include <blkid/blkid.h>
 #include <sys/vfs.h>
+#include <sched.h>
 #include <errno.h>
 
 #include <string>
@@ -43,6 +46,8 @@
 #include <set>
 #include <vector>
 #include <future>
+#include <chrono>
+#include <algorithm>
 
 #include <sqlite3.h>
 
@@ -60,15 +65,23 @@
 #include "src/connector/Connector.h"
 
 #include "SubServer.h"
+#include "Affinity.h"
+#include "ThreadPoolStats.h"
 #include "ThreadPool.h"
 #include "Status.h"
+#include "RequestCounter.h"
 #include "DataBase.h"
+#include "IndexParser.h"
+#include "Catalog.h"
+#include "Reconcile.h"
 #include "FileOperation.h"
 #include "MessageParser.h"
 #include "Receiver.h"
+#include "ChunkReader.h"
 #include "Migration.h"
 #include "SelRecall.h"
 #include "TransRecall.h"
+#include "RecallCache.h"
 #include "Server.h"
 #include "TapeMover.h"
 #include "TapeHandler.h"
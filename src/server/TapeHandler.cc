@@ -17,6 +17,15 @@
 
 #include "ServerIncludes.h"
 
+/*
+ * The state of pending format and check requests is kept by tape id.
+ * The cartridge objects cannot be used for that since they are replaced
+ * when the inventory is refreshed while the request is processed.
+ */
+std::mutex TapeHandler::mtx;
+std::condition_variable TapeHandler::cond;
+std::map<std::string, TapeHandler::pending_t> TapeHandler::pending;
+
 void TapeHandler::addRequest()
 
 {
@@ -27,6 +36,11 @@ void TapeHandler::addRequest()
 
     TRACE(Trace::always, op, tapeId, poolName);
 
+    {
+        std::lock_guard<std::mutex> plock(TapeHandler::mtx);
+        pending[tapeId] = (pending_t ) { false, Error::OK };
+    }
+
     stmt(TapeHandler::ADD_REQUEST)
             << (op == TapeHandler::FORMAT ? DataBase::FORMAT : DataBase::CHECK)
             << reqNumber << Const::UNSET << tapeId << poolName << time(NULL)
@@ -40,8 +54,10 @@ void TapeHandler::addRequest()
 void TapeHandler::execRequest()
 
 {
+    RequestCounter::Guard guard;
     std::shared_ptr<LTFSDMCartridge> cart;
     SQLStatement stmt;
+    Error result = Error::OK;
 
     TRACE(Trace::always, op, driveId, tapeId, poolName);
 
@@ -64,6 +80,8 @@ void TapeHandler::execRequest()
                 MSG(LTFSDMS0115E, tapeId, e.what());
                 THROW(Error::GENERAL_ERROR);
             }
+            // the data of former migrations is gone
+            Catalog::removeTape(tapeId);
         } else {
             try {
                 cart->get_le()->Check(driveId);
@@ -76,10 +94,10 @@ void TapeHandler::execRequest()
         try {
             inventory->poolAdd(poolName, tapeId);
         } catch (const LTFSDMException& e) {
-            cart->result = e.getError();
+            result = e.getError();
             MSG(LTFSDMS0117E, tapeId, poolName, e.what());
         } catch (const std::exception& e) {
-            cart->result = Error::GENERAL_ERROR;
+            result = Error::GENERAL_ERROR;
             MSG(LTFSDMS0117E, tapeId, poolName, e.what());
         }
 
@@ -89,6 +107,7 @@ void TapeHandler::execRequest()
 
         stmt.doall();
     } catch (const std::exception& e) {
+        result = Error::GENERAL_ERROR;
         MSG(LTFSDMS0109E, tapeId, poolName);
     }
 
@@ -96,23 +115,42 @@ void TapeHandler::execRequest()
 
     {
         std::lock_guard<std::recursive_mutex> llock(LTFSDMInventory::mtx);
-        if (inventory->getCartridge(tapeId)->getState()
-                == LTFSDMCartridge::TAPE_INUSE)
-            inventory->getCartridge(tapeId)->setState(
-                    LTFSDMCartridge::TAPE_MOUNTED);
+
+        // only this cartridge has changed, other drives may be busy
+        try {
+            inventory->inventorize(tapeId);
+        } catch (const std::exception& e) {
+            MSG(LTFSDMS0101E, e.what());
+        }
 
         inventory->getDrive(driveId)->setFree();
         inventory->getDrive(driveId)->clearToUnblock();
     }
 
-    try {
-        inventory->inventorize();
-    } catch (const std::exception& e) {
-        MSG(LTFSDMS0101E, e.what());
+    {
+        std::lock_guard<std::mutex> lock(TapeHandler::mtx);
+        pending[tapeId] = (pending_t ) { true, result };
+        cond.notify_all();
     }
 
-    std::unique_lock<std::mutex> lock(cart->mtx);
-    cart->cond.notify_one();
-
     Scheduler::invoke();
 }
+
+Error TapeHandler::waitRequest(std::string tapeId)
+
+{
+    std::map<std::string, pending_t>::iterator it;
+    Error result;
+
+    std::unique_lock<std::mutex> lock(TapeHandler::mtx);
+
+    if ((it = pending.find(tapeId)) == pending.end())
+        return Error::GENERAL_ERROR;
+
+    cond.wait(lock, [tapeId] {return pending[tapeId].done == true;});
+
+    result = pending[tapeId].result;
+    pending.erase(tapeId);
+
+    return result;
+}
@@ -24,6 +24,15 @@ private:
     std::string tapeId;
     int reqNum;
 
+    struct pending_t
+    {
+        bool done;
+        Error result;
+    };
+    static std::mutex mtx;
+    static std::condition_variable cond;
+    static std::map<std::string, pending_t> pending;
+
     static const std::string ADD_REQUEST;
     static const std::string DELETE_REQUEST;
 public:
@@ -47,4 +56,5 @@ public:
     }
     void addRequest();
     void execRequest();
+    static Error waitRequest(std::string tapeId);
 };
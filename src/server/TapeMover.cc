@@ -38,6 +38,7 @@ void TapeMover::addRequest()
 void TapeMover::execRequest()
 
 {
+    RequestCounter::Guard guard;
     std::shared_ptr<LTFSDMCartridge> cart;
     SQLStatement stmt;
 
@@ -35,6 +35,13 @@
     - the maximum number of threads
     - the name of the threads
 
+    Each ThreadPool maintains statistics about its threads and the time
+    tasks are waiting and running, see @subpage thread_pool_stats.
+
+    The threads of a ThreadPool can be bound to a set of CPUs by the
+    ThreadPool::setAffinity method. Threads that are already running keep
+    their affinity, see @ref thread_affinity.
+
     A new thread can be enqueued with the ThreadPool::enqueue method.
     Only the function (that has been specified with the constructor)
     parameters and if necessary (if not Const::UNSET should be specified)
@@ -82,22 +89,29 @@ private:
     std::thread *new_thread;
     std::thread *last_thread;
     const std::string name;
+    std::string cpuList;
+    ThreadPoolStats stats;
+    std::chrono::steady_clock::time_point enqueue_time;
 
     void threadfunc()
     {
         int req_num;
         std::thread *t = last_thread;
+        std::chrono::steady_clock::time_point start;
 
         pthread_setname_np(pthread_self(), name.c_str());
 
         std::packaged_task < void() > ltask;
         std::unique_lock < std::mutex > lock(mtx_main);
+        Affinity::bindThread(cpuList);
+        stats.threadStarted();
         started++;
         cond_init.notify_one();
 
         while (true) {
             cond_main.wait_for(lock, Const::IDLE_THREAD_LIVE_TIME);
             if (new_work == false) {
+                stats.threadFinished();
                 lock.unlock();
                 if (t == nullptr) {
                     num_thrds_started--;
@@ -114,6 +128,7 @@ private:
             occupied++;
             req_num = global_req_num;
             numJobs[req_num]++;
+            stats.taskStarted(enqueue_time);
 
             ltask = std::move(task);
 
@@ -123,8 +138,10 @@ private:
             cond_resp.notify_one();
             lock2.unlock();
 
+            start = std::chrono::steady_clock::now();
             ltask();
             ltask.reset();
+            stats.taskFinished(start);
 
             lock.lock();
 
@@ -141,13 +158,24 @@ public:
             std::string name_) :
             started(0), occupied(0), new_work(false), func(func_), num_thrds(
                     num_thrds_), num_thrds_started(0), new_thread(nullptr), last_thread(
-                    nullptr), name(name_)
+                    nullptr), name(name_), stats(name_, num_thrds_)
 
     {
     }
 
+    void setAffinity(std::string cpuList_)
+    {
+        std::lock_guard < std::mutex > lock(mtx_main);
+        cpuList = cpuList_;
+    }
+
     void enqueue(int req_num, Args ... args)
     {
+        std::chrono::steady_clock::time_point now =
+                std::chrono::steady_clock::now();
+
+        stats.enqueued();
+
         std::lock_guard < std::mutex > elock(enqueue_mtx);
         std::unique_lock < std::mutex > lock(mtx_main);
         new_work = true;
@@ -163,6 +191,7 @@ public:
         }
 
         global_req_num = req_num;
+        enqueue_time = now;
 
         std::packaged_task < void() > task_(std::bind(func, args ...));
         task = std::move(task_);
@@ -0,0 +1,157 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#include "ServerIncludes.h"
+
+/** @page thread_pool_stats ThreadPool Statistics
+
+    # ThreadPoolStats
+
+    Each ThreadPool object contains a ThreadPoolStats object that counts
+    the following values:
+
+    value | description
+    ---|---
+    started | number of threads currently existing
+    active | number of threads currently executing a task
+    queued | number of ThreadPool::enqueue calls waiting for a thread
+    completed | number of tasks completed
+    wait time | histogram of the time between calling ThreadPool::enqueue and the start of the task
+    run time | histogram of the execution time of the tasks
+
+    The histograms consist of ThreadPoolStats::NUM_BUCKETS buckets with the upper
+    limits 10us, 100us, 1ms, 10ms, 100ms, 1s, 10s and unlimited.
+
+    All counters are atomic variables that are updated without further
+    locking. The ThreadPoolStats objects register themselves in a list
+    that is evaluated by the info threads command
+    (see MessageParser::infoThreadsMessage).
+
+ */
+
+std::mutex ThreadPoolStats::mtx;
+
+/*
+ * Thread pools can be static objects of other translation units. The list
+ * therefore is created on first use.
+ */
+std::list<ThreadPoolStats *>& ThreadPoolStats::getPools()
+
+{
+    static std::list<ThreadPoolStats *> pools;
+
+    return pools;
+}
+
+ThreadPoolStats::ThreadPoolStats(std::string name_, int maxThreads_) :
+        name(name_), maxThreads(maxThreads_), started(0), active(0), queued(0), completed(
+                0)
+
+{
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        waitTime[i] = 0;
+        runTime[i] = 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    getPools().push_back(this);
+}
+
+ThreadPoolStats::~ThreadPoolStats()
+
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    getPools().remove(this);
+}
+
+int ThreadPoolStats::bucket(std::chrono::steady_clock::duration duration)
+
+{
+    long usecs =
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    long limit = 10;
+    int i;
+
+    for (i = 0; i < NUM_BUCKETS - 1; i++) {
+        if (usecs < limit)
+            break;
+        limit *= 10;
+    }
+
+    return i;
+}
+
+void ThreadPoolStats::threadStarted()
+
+{
+    started++;
+}
+
+void ThreadPoolStats::threadFinished()
+
+{
+    started--;
+}
+
+void ThreadPoolStats::enqueued()
+
+{
+    queued++;
+}
+
+void ThreadPoolStats::taskStarted(
+        std::chrono::steady_clock::time_point enqueueTime)
+
+{
+    queued--;
+    active++;
+    waitTime[bucket(std::chrono::steady_clock::now() - enqueueTime)]++;
+}
+
+void ThreadPoolStats::taskFinished(
+        std::chrono::steady_clock::time_point startTime)
+
+{
+    runTime[bucket(std::chrono::steady_clock::now() - startTime)]++;
+    completed++;
+    active--;
+}
+
+std::list<ThreadPoolStats::stats_t> ThreadPoolStats::getAll()
+
+{
+    std::list<ThreadPoolStats::stats_t> statsList;
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    for (ThreadPoolStats *pool : getPools()) {
+        ThreadPoolStats::stats_t stats;
+
+        stats.name = pool->name;
+        stats.maxThreads = pool->maxThreads;
+        stats.started = pool->started;
+        stats.active = pool->active;
+        stats.queued = pool->queued;
+        stats.completed = pool->completed;
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            stats.waitTime[i] = pool->waitTime[i];
+            stats.runTime[i] = pool->runTime[i];
+        }
+        statsList.push_back(stats);
+    }
+
+    return statsList;
+}
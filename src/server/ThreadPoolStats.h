@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright 2018 IBM Corp. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *******************************************************************************/
+#pragma once
+
+class ThreadPoolStats
+{
+public:
+    static const int NUM_BUCKETS = Const::THREAD_STATS_BUCKETS;
+    struct stats_t
+    {
+        std::string name;
+        int maxThreads;
+        int started;
+        int active;
+        unsigned long queued;
+        unsigned long completed;
+        unsigned long waitTime[NUM_BUCKETS];
+        unsigned long runTime[NUM_BUCKETS];
+    };
+private:
+    static std::mutex mtx;
+    static std::list<ThreadPoolStats *>& getPools();
+
+    const std::string name;
+    const int maxThreads;
+    std::atomic<int> started;
+    std::atomic<int> active;
+    std::atomic<unsigned long> queued;
+    std::atomic<unsigned long> completed;
+    std::atomic<unsigned long> waitTime[NUM_BUCKETS];
+    std::atomic<unsigned long> runTime[NUM_BUCKETS];
+
+    static int bucket(std::chrono::steady_clock::duration duration);
+public:
+    ThreadPoolStats(std::string name_, int maxThreads_);
+    ~ThreadPoolStats();
+    void threadStarted();
+    void threadFinished();
+    void enqueued();
+    void taskStarted(std::chrono::steady_clock::time_point enqueueTime);
+    void taskFinished(std::chrono::steady_clock::time_point startTime);
+    static std::list<stats_t> getAll();
+};
@@ -335,6 +335,10 @@ void TransRecall::addJob(Connector::rec_info_t recinfo, std::string tapeId,
 
         attr = fso.getAttribute();
 
+        if (attr.tapeInfo[0].startBlock == Const::UNSET)
+            attr.tapeInfo[0].startBlock = Catalog::getStartBlock(tapeId,
+                    recinfo.fuid);
+
         tapeName = Server::getTapeName(recinfo.fuid.fsid_h, recinfo.fuid.fsid_l,
                 recinfo.fuid.igen, recinfo.fuid.inum, tapeId);
     } catch (const std::exception& e) {
@@ -403,6 +407,41 @@ void TransRecall::cleanupEvents()
     stmt.finalize();
 }
 
+void TransRecall::manageFs(std::string fs, struct timespec starttime,
+        std::shared_ptr<std::atomic<int>> numManaged)
+
+{
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+
+    try {
+        FsObj fileSystem(fs);
+        if (fileSystem.isFsManaged()) {
+            MSG(LTFSDMS0042I, fs);
+            fileSystem.manageFs(true, starttime);
+            (*numManaged)++;
+            MSG(LTFSDMS0119I, fs,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - start).count());
+            recallCache.addFs(fs);
+        }
+    } catch (const LTFSDMException& e) {
+        TRACE(Trace::error, e.what());
+        switch (e.getError()) {
+            case Error::FS_CHECK_ERROR:
+                MSG(LTFSDMS0044E, fs);
+                break;
+            case Error::FS_ADD_ERROR:
+                MSG(LTFSDMS0045E, fs);
+                break;
+            default:
+                MSG(LTFSDMS0045E, fs);
+        }
+    } catch (const std::exception& e) {
+        TRACE(Trace::error, e.what());
+    }
+}
+
 void TransRecall::run(std::shared_ptr<Connector> connector)
 
 {
@@ -413,6 +452,8 @@ void TransRecall::run(std::shared_ptr<Connector> connector)
     std::map<std::string, long> reqmap;
     std::string tapeId;
 
+    wqr.setAffinity(Affinity::getCpus("recall"));
+
     try {
         connector->initTransRecalls();
     } catch (const std::exception& e) {
@@ -422,30 +463,24 @@ void TransRecall::run(std::shared_ptr<Connector> connector)
     }
 
     try {
-        FileSystems fss;
-        for (std::string fs : Server::conf.getFss()) {
-            try {
-                FsObj fileSystem(fs);
-                if (fileSystem.isFsManaged()) {
-                    MSG(LTFSDMS0042I, fs);
-                    fileSystem.manageFs(true, connector->getStartTime());
-                }
-            } catch (const LTFSDMException& e) {
-                TRACE(Trace::error, e.what());
-                switch (e.getError()) {
-                    case Error::FS_CHECK_ERROR:
-                        MSG(LTFSDMS0044E, fs);
-                        break;
-                    case Error::FS_ADD_ERROR:
-                        MSG(LTFSDMS0045E, fs);
-                        break;
-                    default:
-                        MSG(LTFSDMS0045E, fs);
-                }
-            } catch (const std::exception& e) {
-                TRACE(Trace::error, e.what());
-            }
-        }
+        std::set<std::string> fss = Server::conf.getFss();
+        std::shared_ptr<std::atomic<int>> numManaged = std::make_shared<
+                std::atomic<int>>(0);
+        std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+        ThreadPool<std::string, struct timespec,
+                std::shared_ptr<std::atomic<int>>> wqf(&TransRecall::manageFs,
+                Const::MAX_MOUNT_THREADS, "mount-wq");
+
+        for (std::string fs : fss)
+            wqf.enqueue(Const::UNSET, fs, connector->getStartTime(),
+                    numManaged);
+
+        wqf.waitCompletion(Const::UNSET);
+
+        MSG(LTFSDMS0120I, (int) *numManaged, (int) fss.size(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start).count());
     } catch (const std::exception& e) {
         MSG(LTFSDMS0079E, e.what());
     }
@@ -520,7 +555,8 @@ void TransRecall::run(std::shared_ptr<Connector> connector)
 }
 
 unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
-        std::string tapeId, FsObj::file_state state, FsObj::file_state toState)
+        std::string tapeId, std::string driveId, FsObj::file_state state,
+        FsObj::file_state toState)
 
 {
     struct stat statbuf;
@@ -531,7 +567,14 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
     long wsize;
     int fd = -1;
     long offset = 0;
+    long untimed = 0;
     FsObj::file_state curstate;
+    std::shared_ptr<LTFSDMDrive> drive = inventory->getDrive(driveId);
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration =
+            std::chrono::steady_clock::duration::zero();
+
+    statbuf.st_size = 0;
 
     try {
         FsObj target(recinfo);
@@ -581,12 +624,20 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
                 if (Server::forcedTerminate)
                     THROW(Error::GENERAL_ERROR, tapeName);
 
+                start = std::chrono::steady_clock::now();
                 rsize = read(fd, buffer, sizeof(buffer));
+                // the first read includes positioning to the start block
+                if (offset == 0)
+                    untimed = rsize;
+                else
+                    duration += std::chrono::steady_clock::now() - start;
                 if (rsize == 0) {
                     break;
                 }
                 if (rsize == -1) {
                     TRACE(Trace::error, errno);
+                    if (drive != nullptr)
+                        drive->addError();
                     MSG(LTFSDMS0023E, tapeName.c_str());
                     THROW(Error::GENERAL_ERROR, tapeName, errno);
                 }
@@ -602,6 +653,9 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
             }
 
             close(fd);
+            if (drive != nullptr)
+                drive->addTransfer(LTFSDMDrive::READ, offset - untimed,
+                        duration);
         }
 
         target.finishRecall(toState);
@@ -617,7 +671,8 @@ unsigned long TransRecall::recall(Connector::rec_info_t recinfo,
     return statbuf.st_size;
 }
 
-void TransRecall::processFiles(int reqNum, std::string tapeId)
+void TransRecall::processFiles(int reqNum, std::string driveId,
+        std::string tapeId)
 
 {
     Connector::rec_info_t recinfo;
@@ -631,6 +686,7 @@ void TransRecall::processFiles(int reqNum, std::string tapeId)
     std::list<respinfo_t> resplist;
     int numFiles = 0;
     bool succeeded;
+    unsigned long size;
 
     stmt(TransRecall::SET_RECALLING) << FsObj::RECALLING_MIG << reqNum
             << FsObj::MIGRATED << tapeId;
@@ -663,8 +719,11 @@ void TransRecall::processFiles(int reqNum, std::string tapeId)
                 toState);
 
         try {
-            recall(recinfo, tapeId, state, toState);
+            size = recall(recinfo, tapeId, driveId, state, toState);
             succeeded = true;
+            if (state == FsObj::MIGRATED && toState == FsObj::PREMIGRATED
+                    && size > 0)
+                recallCache.add(recinfo, size);
         } catch (const std::exception& e) {
             TRACE(Trace::error, e.what());
             succeeded = false;
@@ -689,12 +748,15 @@ void TransRecall::execRequest(int reqNum, std::string driveId,
         std::string tapeId)
 
 {
+    RequestCounter::Guard guard;
     SQLStatement stmt;
     int remaining = 0;
 
     TRACE(Trace::always, reqNum, tapeId);
 
-    processFiles(reqNum, tapeId);
+    Affinity::bindThreadToDrive(driveId);
+
+    processFiles(reqNum, driveId, tapeId);
 
     {
         std::lock_guard<std::recursive_mutex> inventorylock(
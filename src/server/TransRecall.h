@@ -31,7 +31,9 @@ private:
     static const std::string COUNT_REMAINING_JOBS;
     static const std::string DELETE_REQUEST;
 
-    void processFiles(int reqNum, std::string tapeId);
+    void processFiles(int reqNum, std::string driveId, std::string tapeId);
+    static void manageFs(std::string fs, struct timespec starttime,
+            std::shared_ptr<std::atomic<int>> numManaged);
 public:
     TransRecall()
     {
@@ -43,8 +45,8 @@ public:
     void cleanupEvents();
     void run(std::shared_ptr<Connector> connector);
     static unsigned long recall(Connector::rec_info_t recinfo,
-            std::string tapeId, FsObj::file_state state,
-            FsObj::file_state toState);
+            std::string tapeId, std::string driveId,
+            FsObj::file_state state, FsObj::file_state toState);
 
     void execRequest(int reqNum, std::string driveId, std::string tapeId);
 };
@@ -141,7 +141,7 @@
     ---|---|---|---
     message parsing | Receiver::run -> wqm | MessageParser::run | After the Receiver gets a new message this message is further processed by a new thread from this thread pool.
     premigration | LTFSDMDrive::wqp | Migration::preMigrate | For premigration there is one thread pool per drive since only a single request can be executed on a certain drive at a time.
-    stubbing | Server::wqs | Migration::stub | There exist one thread pool for all stubbing operations (even from different requests).
+    stubbing | Server::wqs | Migration::changeFileStates | There exist one thread pool for all stubbing operations (even from different requests). Each thread processes a batch of up to Const::STUBBING_BATCH_SIZE files.
     transparent recall | TransRecall::run -> wqr | TransRecall::addJob | For adding transparent recall requests and jobs.
 
     Overall this leads to the following picture:
@@ -162,6 +162,7 @@
             Receiver::run -> wqm (1 thread pool)
         TransRecall::run (1 thread)
             TransRecall::run -> wqr (1 thread pool)
+        RecallCache::run (1 thread, re-stubs recalled files, see @ref recall_cache)
     @endverbatim
 
     To create threads there are two facilities created:
@@ -173,6 +174,9 @@
       after the thread function terminates. Within these 10 seconds it
       is possible to reuse them. See @subpage thread_pool.
 
+    The threads performing data transfers and stubbing can be bound to
+    CPUs near the corresponding host bus adapter. See @subpage thread_affinity.
+
 
     ## Backend Processing
 
@@ -182,6 +186,7 @@
     - @subpage scheduler
     - @subpage migration
     - @subpage selective_recall
+    - @subpage request_counter
 
     Furthermore for transparent recalling the following section is available:
 
@@ -200,7 +205,10 @@
     be created for each managed file system. The creation of the drive and
     cartridge inventory in the following is called inventorize. During this
     operation premigration thread pools are created: one pool for each drive.
-    A thread pool for the stubbing operation is setup. Thereafter the threads
+    Later synchronizations with LTFS LE (e.g. by the ltfsdm retrieve command
+    or after a failed mount) are performed by LTFSDMInventory::refresh which
+    only updates the entries that have been changed and keeps the existing
+    thread pools. A thread pool for the stubbing operation is setup. Thereafter the threads
     for scheduling, signal handling, the receiver, and the listener for the
     transparent recall requests are started.
 
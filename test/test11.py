@@ -0,0 +1,118 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the throughput of the transfer of large file lists from the
+# client to the backend. Messages of at least Const::COMM_SHM_MIN_SIZE
+# bytes are transferred by a shared memory ring instead of the socket.
+# For file lists of increasing size the elapsed time of a recall of
+# resident files is printed. A second run traced by strace counts the
+# bytes sent over the socket and checks that the ring has been set up.
+# Run it with a build without the ring to get the figures of the socket
+# transfer. For lists of at least minlist bytes the test fails if the
+# ring has not been set up or if at least half of the list has been
+# sent over the socket. The number of files can be provided as an
+# argument.
+
+import sys
+import os
+import re
+import time
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test11/"
+filelist = "/dev/shm/test11.list"
+trace = "/dev/shm/test11.strace"
+numfiles = 1000000
+perdir = 1000
+minlist = 1024 * 1024
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles():
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    names = []
+    for i in range(numfiles):
+        dirname = mandir + testdir + "dir." + str(i // perdir)
+        if i % perdir == 0 and os.path.isdir(dirname) == 0:
+            os.mkdir(dirname)
+        name = dirname + "/file." + str(i)
+        if os.path.isfile(name) == 0:
+            open(name, "w").close()
+        names.append(name)
+    return names
+
+def socketbytes():
+    sent = 0
+    memfd = False
+    pattern = re.compile(r'(sendmsg|sendto|write)\((\d+)<(socket|UNIX)[^>]*>.*\) = (\d+)$')
+    with open(trace) as f:
+        for line in f:
+            if "memfd_create" in line:
+                memfd = True
+            match = pattern.search(line.strip())
+            if match:
+                sent += int(match.group(4))
+    return sent, memfd
+
+def main(argv):
+    global numfiles
+
+    if len(argv) > 0:
+        numfiles = int(argv[0])
+
+    names = crfiles()
+
+    count = 1000
+    while count <= numfiles:
+        with open(filelist, "w") as f:
+            for name in names[:count]:
+                f.write(name + "\n")
+        listsize = os.path.getsize(filelist)
+
+        start = time.time()
+        run(["ltfsdm", "recall", "-f", filelist])
+        secs = time.time() - start
+
+        run(["strace", "-f", "-y", "-o", trace,
+             "-e", "trace=memfd_create,sendmsg,sendto,write",
+             "ltfsdm", "recall", "-f", filelist])
+        sent, memfd = socketbytes()
+
+        print(str(count) + " names (" + str(listsize) + " bytes): "
+              + "%.3f" % secs + " seconds, "
+              + "%.1f" % (listsize / secs / 1024 / 1024) + " MB/s, "
+              + str(sent) + " bytes over the socket, shared memory "
+              + ("used" if memfd else "not used"))
+
+        if listsize >= minlist and (memfd == False or sent >= listsize / 2):
+            print("the file list has not been transferred by shared memory")
+            sys.exit(-1)
+
+        count *= 10
+
+    os.remove(filelist)
+    os.remove(trace)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
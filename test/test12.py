@@ -0,0 +1,105 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures statfs calls on a managed file system whose backing file
+# system is slow. The backing file system is an NFS mount of a local
+# export. The latency of the loopback device is increased by netem, so
+# every statfs that is forwarded to NFS costs a round trip. The calls
+# are timed on the plain NFS mount first and then, after the file
+# system has been added, through the overlay, which caches the results
+# for Const::OVERLAY_STATFS_TTL. A df loop is run in addition. Each
+# forwarded call costs at least the delay, so the test fails if the
+# statfs calls through the overlay are not at least minspeedup times
+# faster than on the plain NFS mount. The delay in ms can be provided
+# as an argument.
+
+import sys
+import os
+import time
+import subprocess
+
+export = "/var/tmp/test12.export"
+mountpt = "/mnt/test12"
+delay = 5
+numcalls = 1000
+numdf = 100
+minspeedup = 10.0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def prepare():
+    for d in [export, mountpt]:
+        if os.path.isdir(d) == 0:
+            os.mkdir(d)
+    run(["exportfs", "-o", "rw,no_root_squash,sync", "localhost:" + export])
+    if os.path.ismount(mountpt) == 0:
+        run(["mount", "-t", "nfs", "localhost:" + export, mountpt])
+
+def cleanup():
+    subprocess.call(["tc", "qdisc", "del", "dev", "lo", "root"])
+
+def statfsloop(label):
+    start = time.time()
+    for i in range(numcalls):
+        os.statvfs(mountpt)
+    secs = time.time() - start
+    print(label + ": " + str(numcalls) + " statfs calls in " + "%.3f" % secs
+          + " seconds, " + "%.0f" % (numcalls / secs) + " calls/s")
+    return numcalls / secs
+
+def dfloop(label):
+    start = time.time()
+    for i in range(numdf):
+        run(["df", mountpt])
+    secs = time.time() - start
+    print(label + ": " + str(numdf) + " df calls in " + "%.3f" % secs
+          + " seconds")
+
+def main(argv):
+    global delay
+
+    if len(argv) > 0:
+        delay = int(argv[0])
+
+    prepare()
+
+    run(["tc", "qdisc", "add", "dev", "lo", "root", "netem", "delay",
+         str(delay) + "ms"])
+
+    try:
+        nfsrate = statfsloop("NFS")
+        dfloop("NFS")
+
+        run(["ltfsdm", "add", mountpt])
+
+        managedrate = statfsloop("managed")
+        dfloop("managed")
+    finally:
+        cleanup()
+
+    if managedrate < minspeedup * nfsrate:
+        print("statfs through the overlay is not " + str(minspeedup)
+              + " times faster than on the NFS mount")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,114 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Checks the locally maintained cartridge capacity. Files are migrated
+# to a pool while "ltfsdm info pools" is queried in a loop. The queries
+# read the capacity without waiting for the data movers, so none of them
+# may take longer than maxsecs. After the migration the remaining
+# capacity of the pool has to be reduced by at least the amount of data
+# written. The number of files can be provided as an argument.
+
+import sys
+import os
+import time
+import threading
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test13/"
+filelist = "/dev/shm/test13.list"
+numfiles = 10000
+size = 1048576
+pool = "pool1"
+maxsecs = 1.0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def remcap():
+    output = subprocess.check_output(["ltfsdm", "info", "pools"]).decode()
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 5 and fields[0] == pool:
+            return int(fields[2])
+    print("pool " + pool + " not found")
+    sys.exit(-1)
+
+def crfiles():
+    data = os.urandom(size)
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            name = mandir + testdir + "file." + str(i)
+            with open(name, "wb") as df:
+                df.write(data)
+            f.write(name + "\n")
+
+def poll(done, latencies):
+    while not done.is_set():
+        start = time.time()
+        remcap()
+        latencies.append(time.time() - start)
+
+def main(argv):
+    global numfiles
+
+    if len(argv) > 0:
+        numfiles = int(argv[0])
+
+    crfiles()
+
+    before = remcap()
+
+    done = threading.Event()
+    latencies = []
+    poller = threading.Thread(target=poll, args=(done, latencies))
+    poller.start()
+
+    start = time.time()
+    run(["ltfsdm", "migrate", "-p", "-P", pool, "-f", filelist])
+    secs = time.time() - start
+
+    done.set()
+    poller.join()
+
+    after = remcap()
+    written = numfiles * size // (1024 * 1024)
+
+    print("migration of " + str(numfiles) + " files: " + "%.3f" % secs + " seconds")
+    print(str(len(latencies)) + " info pools queries, max " + "%.3f" % max(latencies)
+          + " seconds, average " + "%.3f" % (sum(latencies) / len(latencies)) + " seconds")
+    print("remaining capacity of " + pool + ": " + str(before) + " MB before, "
+          + str(after) + " MB after, " + str(written) + " MB written")
+
+    os.remove(filelist)
+
+    if max(latencies) > maxsecs:
+        print("info pools took longer than " + str(maxsecs) + " seconds")
+        sys.exit(-1)
+
+    if before - after < written:
+        print("the remaining capacity has not been reduced by the data written")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
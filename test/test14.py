@@ -0,0 +1,102 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the rate at which the DMAPI connector takes recall events
+# under a recall storm. Small files on a DMAPI enabled file system are
+# migrated and then read by many processes at the same time. Each first
+# read causes a read event that needs to be retrieved and answered
+# before the read returns, so the number of files divided by the
+# elapsed time is the events per second handled end to end. The test
+# fails if the rate is below minrate. The mount point of the DMAPI file
+# system and the minimum rate can be provided as arguments.
+
+import sys
+import os
+import time
+import multiprocessing
+import contextlib
+import subprocess
+
+mandir = "/mnt/xfs/"
+testdir = "test14/"
+filelist = "/dev/shm/test14.list"
+numfiles = 20000
+size = 4096
+numprocs = 500
+pool = "pool1"
+minrate = 200.0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles():
+    data = os.urandom(size)
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    names = []
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            name = mandir + testdir + "file." + str(i)
+            with open(name, "wb") as df:
+                df.write(data)
+            f.write(name + "\n")
+            names.append(name)
+    return names
+
+def readfile(name):
+    with open(name, "rb") as f:
+        if len(f.read(1)) != 1:
+            return 1
+    return 0
+
+def main(argv):
+    global mandir
+    global minrate
+
+    if len(argv) > 0:
+        mandir = argv[0].rstrip("/") + "/"
+    if len(argv) > 1:
+        minrate = float(argv[1])
+
+    names = crfiles()
+    run(["ltfsdm", "migrate", "-P", pool, "-f", filelist])
+
+    start = time.time()
+    with contextlib.closing(multiprocessing.Pool(processes=numprocs)) as procs:
+        failed = sum(procs.imap_unordered(readfile, names, 16))
+    secs = time.time() - start
+
+    rate = numfiles / secs
+    print("transparent recall of " + str(numfiles) + " files by " + str(numprocs)
+          + " processes: " + "%.3f" % secs + " seconds, " + "%.1f" % rate + " events/s")
+
+    os.remove(filelist)
+
+    if failed > 0:
+        print(str(failed) + " files could not be read")
+        sys.exit(-1)
+
+    if rate < minrate:
+        print("less than " + str(minrate) + " events/s")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,135 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Checks the recall cache limit of a single file system and the
+# reconstruction of the cache after a restart. Files are premigrated and
+# the access time of half of them is set to two hours ago. Afterwards
+# the recall cache limit of the file system is set to the size of half
+# of the files within the configuration file and the server is
+# restarted. When the file system is managed again the server scans it
+# for premigrated files and has to re-stub the files with the old access
+# time while the recently accessed files have to stay premigrated. The
+# mount point of the managed file system and the number of files can be
+# provided as arguments.
+
+import sys
+import os
+import time
+import shutil
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test15/"
+filelist = "/dev/shm/test15.list"
+conffile = "/etc/ltfsdm.conf"
+confsave = "/dev/shm/test15.conf"
+numfiles = 1000
+size = 1048576
+pool = "pool1"
+timeout = 300
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles():
+    data = os.urandom(size)
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    names = []
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            name = mandir + testdir + "file." + str(i)
+            with open(name, "wb") as df:
+                df.write(data)
+            f.write(name + "\n")
+            names.append(name)
+    return names
+
+def states():
+    output = subprocess.check_output(["ltfsdm", "info", "files", "-f", filelist]).decode()
+    result = {}
+    for line in output.splitlines()[1:]:
+        fields = line.split()
+        if len(fields) == 5:
+            result[fields[4]] = fields[0]
+    return result
+
+def restart():
+    run(["ltfsdm", "stop"])
+    run(["ltfsdm", "start"])
+
+def main(argv):
+    global mandir
+    global numfiles
+
+    if len(argv) > 0:
+        mandir = argv[0].rstrip("/") + "/"
+    if len(argv) > 1:
+        numfiles = int(argv[1])
+
+    names = crfiles()
+    run(["ltfsdm", "migrate", "-p", "-P", pool, "-f", filelist])
+
+    old = names[:numfiles // 2]
+    recent = names[numfiles // 2:]
+    for name in old:
+        statbuf = os.stat(name)
+        os.utime(name, (time.time() - 7200, statbuf.st_mtime))
+
+    shutil.copyfile(conffile, confsave)
+    with open(conffile, "a") as f:
+        f.write("recallcache: " + mandir.rstrip("/") + " " + str(len(recent) * size) + "\n")
+
+    try:
+        start = time.time()
+        restart()
+        while True:
+            result = states()
+            if all(result.get(name) == "m" for name in old):
+                break
+            if time.time() - start > timeout:
+                break
+            time.sleep(5)
+        secs = time.time() - start
+    finally:
+        shutil.copyfile(confsave, conffile)
+        os.remove(confsave)
+        restart()
+
+    os.remove(filelist)
+
+    stubbed = sum(1 for name in old if result.get(name) == "m")
+    kept = sum(1 for name in recent if result.get(name) == "p")
+
+    print(str(stubbed) + " of " + str(len(old)) + " files with an old access time re-stubbed, "
+          + str(kept) + " of " + str(len(recent)) + " recently accessed files premigrated after "
+          + "%.1f" % secs + " seconds")
+
+    if stubbed != len(old):
+        print("the recall cache has not been rebuilt or not been shrunk to its limit")
+        sys.exit(-1)
+
+    if kept != len(recent):
+        print("the recall cache has re-stubbed more files than required by its limit")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
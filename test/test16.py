@@ -0,0 +1,98 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the per file overhead of migrations. Small files are migrated
+# once from a flat directory and once from a directory nested depth
+# levels deep. The data transfer and the stubbing open the files by the
+# file handle recorded when the job has been added and do not resolve
+# the path again. Therefore the time per file must not grow much with
+# the directory depth. The test fails if a file in the nested directory
+# takes more than maxratio times as long as a file in the flat directory
+# or if a file takes longer than maxms. The mount point of the managed
+# file system and the number of files can be provided as arguments.
+
+import sys
+import os
+import time
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test16/"
+filelist = "/dev/shm/test16.list"
+numfiles = 10000
+size = 1024
+depth = 32
+pool = "pool1"
+maxratio = 1.5
+maxms = 10.0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles(dirname):
+    data = os.urandom(size)
+    if os.path.isdir(dirname) == 0:
+        os.makedirs(dirname)
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            name = dirname + "file." + str(i)
+            with open(name, "wb") as df:
+                df.write(data)
+            f.write(name + "\n")
+
+def migrate(dirname):
+    crfiles(dirname)
+    start = time.time()
+    run(["ltfsdm", "migrate", "-p", "-P", pool, "-f", filelist])
+    premig = (time.time() - start) * 1000 / numfiles
+    start = time.time()
+    run(["ltfsdm", "migrate", "-P", pool, "-f", filelist])
+    stub = (time.time() - start) * 1000 / numfiles
+    os.remove(filelist)
+    return (premig, stub)
+
+def main(argv):
+    global mandir
+    global numfiles
+
+    if len(argv) > 0:
+        mandir = argv[0].rstrip("/") + "/"
+    if len(argv) > 1:
+        numfiles = int(argv[1])
+
+    flat = migrate(mandir + testdir + "flat/")
+    nested = migrate(mandir + testdir + "nested/" + "d/" * depth)
+
+    print("premigration: " + "%.3f" % flat[0] + " ms per file (flat), "
+          + "%.3f" % nested[0] + " ms per file (depth " + str(depth) + ")")
+    print("stubbing: " + "%.3f" % flat[1] + " ms per file (flat), "
+          + "%.3f" % nested[1] + " ms per file (depth " + str(depth) + ")")
+
+    for i in range(2):
+        if nested[i] > maxratio * flat[i]:
+            print("the time per file grows with the directory depth")
+            sys.exit(-1)
+        if max(flat[i], nested[i]) > maxms:
+            print("the time per file is above " + str(maxms) + " ms")
+            sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
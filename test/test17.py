@@ -0,0 +1,87 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Checks that format requests for several cartridges are processed in
+# parallel on all drives. It is intended to run against a virtual tape
+# library (e.g. mhVTL) with unformatted cartridges. The first cartridge
+# is formatted alone to get the time of a single format. The remaining
+# cartridges are formatted with a single "ltfsdm pool add -F" command.
+# Their total time should be the single time multiplied by the number
+# of rounds that the drives need, not by the number of cartridges. The
+# test fails if it takes more than maxratio times as long. The ids of
+# the unformatted cartridges have to be provided as arguments.
+
+import sys
+import os
+import math
+import time
+import subprocess
+
+pool = "test17"
+maxratio = 1.5
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def numdrives():
+    output = subprocess.check_output(["ltfsdm", "info", "drives"]).decode()
+    return len(output.splitlines()) - 1
+
+def format(tapes):
+    args = ["ltfsdm", "pool", "add", "-F", "-P", pool]
+    for tape in tapes:
+        args += ["-t", tape]
+    start = time.time()
+    run(args)
+    return time.time() - start
+
+def main(argv):
+    if len(argv) < 3:
+        print("usage: " + sys.argv[0] + " <tape id> <tape id> <tape id> ...")
+        sys.exit(-1)
+
+    drives = numdrives()
+    if drives < 2:
+        print("at least two drives are required")
+        sys.exit(-1)
+
+    run(["ltfsdm", "pool", "create", "-P", pool])
+
+    single = format(argv[:1])
+    total = format(argv[1:])
+
+    for tape in argv:
+        run(["ltfsdm", "pool", "remove", "-P", pool, "-t", tape])
+    run(["ltfsdm", "pool", "delete", "-P", pool])
+
+    rounds = int(math.ceil(float(len(argv) - 1) / drives))
+
+    print("format of a single cartridge: " + "%.1f" % single + " seconds")
+    print("format of " + str(len(argv) - 1) + " cartridges with " + str(drives)
+          + " drives: " + "%.1f" % total + " seconds, expected about "
+          + "%.1f" % (rounds * single) + " seconds")
+
+    if total > maxratio * rounds * single:
+        print("format requests have not been processed in parallel")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
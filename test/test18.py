@@ -0,0 +1,118 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the cost of formatting a message. Formerly the message text
+# has been parsed by the Boost Format library for each message. Now all
+# message texts are parsed once by Message::Message and each message is
+# formatted with a copy of the parsed format object (Message::prepare).
+# A small program built from the code below formats the same message
+# in both ways and reports the time per message. The test fails if the
+# prepared format object is not at least minspeedup times faster. The
+# number of messages can be provided as an argument.
+
+import sys
+import os
+import re
+import subprocess
+
+srcfile = "/dev/shm/test18.cc"
+binfile = "/dev/shm/test18"
+nummsgs = 1000000
+minspeedup = 1.1
+
+source = r"""
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "boost/format.hpp"
+
+static const std::string text = "LTFSDMS0132W(%04d): Drive %s is degraded: "
+        "write %lu MB/s (peers %lu MB/s), read %lu MB/s (peers %lu MB/s), "
+        "%d error(s) in the last %d transfers.\n";
+
+template<typename F>
+static double measure(long num, F fmt)
+{
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    unsigned long len = 0;
+
+    for (long i = 0; i < num; i++)
+        len += fmt(i).size();
+
+    if (len == 0)
+        std::cerr << "nothing formatted" << std::endl;
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count() / (double) num;
+}
+
+int main(int argc, char **argv)
+{
+    long num = std::stol(argv[1]);
+    boost::format prepared;
+
+    prepared.parse(text);
+
+    double parsed = measure(num, [](long i) {
+        return (boost::format(text) % 1234 % "1068016520" % i % 300 % 290
+                % 310 % 3 % 100).str();
+    });
+    double copied = measure(num, [&prepared](long i) {
+        return (boost::format(prepared) % 1234 % "1068016520" % i % 300 % 290
+                % 310 % 3 % 100).str();
+    });
+
+    std::cout << "parsed: " << parsed << std::endl;
+    std::cout << "prepared: " << copied << std::endl;
+
+    return 0;
+}
+"""
+
+def main(argv):
+    global nummsgs
+
+    if len(argv) > 0:
+        nummsgs = int(argv[0])
+
+    with open(srcfile, "w") as f:
+        f.write(source)
+
+    if subprocess.call(["g++", "-std=c++11", "-O2", "-o", binfile, srcfile]) != 0:
+        print("command failed: g++")
+        sys.exit(-1)
+
+    output = subprocess.check_output([binfile, str(nummsgs)]).decode()
+
+    os.remove(srcfile)
+    os.remove(binfile)
+
+    parsed = float(re.search("parsed: (.*)", output).group(1))
+    prepared = float(re.search("prepared: (.*)", output).group(1))
+
+    print("parse for each message: " + "%.1f" % parsed + " ns per message")
+    print("copy of the prepared format: " + "%.1f" % prepared + " ns per message")
+
+    if parsed < minspeedup * prepared:
+        print("the prepared format is not " + str(minspeedup) + " times faster")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
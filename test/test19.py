@@ -0,0 +1,84 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the stubbing rate of small files. The files are premigrated
+# first, so the following migration only changes the migration state
+# of the files and truncates them. This is done by the stubbing threads
+# in batches of up to Const::STUBBING_BATCH_SIZE files. The test reports
+# the number of files stubbed per second and fails if it is below
+# minrate. The mount point of the managed file system and the number of
+# files can be provided as arguments.
+
+import sys
+import os
+import time
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test19/"
+filelist = "/dev/shm/test19.list"
+numfiles = 50000
+size = 4096
+pool = "pool1"
+minrate = 1000.0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles():
+    data = os.urandom(size)
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            name = mandir + testdir + "file." + str(i)
+            with open(name, "wb") as df:
+                df.write(data)
+            f.write(name + "\n")
+
+def main(argv):
+    global mandir
+    global numfiles
+
+    if len(argv) > 0:
+        mandir = argv[0].rstrip("/") + "/"
+    if len(argv) > 1:
+        numfiles = int(argv[1])
+
+    crfiles()
+    run(["ltfsdm", "migrate", "-p", "-P", pool, "-f", filelist])
+
+    start = time.time()
+    run(["ltfsdm", "migrate", "-P", pool, "-f", filelist])
+    secs = time.time() - start
+
+    os.remove(filelist)
+
+    rate = numfiles / secs
+    print("stubbing of " + str(numfiles) + " premigrated files: " + "%.3f" % secs
+          + " seconds, " + "%.1f" % rate + " files/s")
+
+    if rate < minrate:
+        print("less than " + str(minrate) + " files/s")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
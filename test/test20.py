@@ -0,0 +1,135 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Compares the premigration throughput with unpinned and pinned data
+# transfer threads. For the unpinned run the CPUs of each drive are set
+# to all CPUs of the host within the configuration file. For the pinned
+# run no CPUs are configured and the threads of each drive are bound to
+# the NUMA node of its host bus adapter. For each run the throughput
+# and the memory allocations that have been satisfied by another NUMA
+# node than intended (numa_miss of /sys/devices/system/node) are
+# reported. The test fails if the pinned run is slower than minratio
+# times the unpinned run or causes more remote allocations. On a host
+# with a single NUMA node only the throughput is compared. The mount
+# point of the managed file system and the number of files can be
+# provided as arguments.
+
+import sys
+import os
+import glob
+import time
+import shutil
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test20/"
+filelist = "/dev/shm/test20.list"
+conffile = "/etc/ltfsdm.conf"
+confsave = "/dev/shm/test20.conf"
+numfiles = 64
+size = 256 * 1048576
+pool = "pool1"
+minratio = 0.95
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles(name):
+    data = os.urandom(1048576)
+    dirname = mandir + testdir + name + "/"
+    if os.path.isdir(dirname) == 0:
+        os.makedirs(dirname)
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            fname = dirname + "file." + str(i)
+            with open(fname, "wb") as df:
+                for j in range(size // 1048576):
+                    df.write(data)
+            f.write(fname + "\n")
+
+def drives():
+    output = subprocess.check_output(["ltfsdm", "info", "drives"]).decode()
+    return [line.split()[0] for line in output.splitlines()[1:] if len(line.split()) > 0]
+
+def numamiss():
+    total = 0
+    for numastat in glob.glob("/sys/devices/system/node/node*/numastat"):
+        with open(numastat) as f:
+            for line in f:
+                fields = line.split()
+                if fields[0] == "numa_miss":
+                    total += int(fields[1])
+    return total
+
+def restart():
+    run(["ltfsdm", "stop"])
+    run(["ltfsdm", "start"])
+
+def premigrate(name):
+    crfiles(name)
+    with open("/proc/sys/vm/drop_caches", "w") as f:
+        f.write("3\n")
+    miss = numamiss()
+    start = time.time()
+    run(["ltfsdm", "migrate", "-p", "-P", pool, "-f", filelist])
+    secs = time.time() - start
+    miss = numamiss() - miss
+    os.remove(filelist)
+    mbps = numfiles * size / 1048576 / secs
+    print(name + ": " + "%.1f" % mbps + " MB/s, " + str(miss) + " remote allocations")
+    return (mbps, miss)
+
+def main(argv):
+    global mandir
+    global numfiles
+
+    if len(argv) > 0:
+        mandir = argv[0].rstrip("/") + "/"
+    if len(argv) > 1:
+        numfiles = int(argv[1])
+
+    numnodes = len(glob.glob("/sys/devices/system/node/node[0-9]*"))
+    allcpus = "0-" + str(os.sysconf("SC_NPROCESSORS_CONF") - 1)
+
+    shutil.copyfile(conffile, confsave)
+    try:
+        with open(conffile, "a") as f:
+            for drive in drives():
+                f.write("affinity: " + drive + " " + allcpus + "\n")
+        restart()
+        unpinned = premigrate("unpinned")
+    finally:
+        shutil.copyfile(confsave, conffile)
+        os.remove(confsave)
+        restart()
+
+    pinned = premigrate("pinned")
+
+    if pinned[0] < minratio * unpinned[0]:
+        print("the pinned threads are slower than the unpinned threads")
+        sys.exit(-1)
+
+    if numnodes > 1 and pinned[1] > unpinned[1]:
+        print("the pinned threads cause more remote allocations")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
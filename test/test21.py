@@ -0,0 +1,129 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures how long the scheduling is blocked by an inventory refresh.
+# It is intended to run against a virtual tape library (e.g. mhVTL).
+# While files are migrated "ltfsdm retrieve" is called repeatedly. Each
+# refresh logs LTFSDMS0124I with the time the inventory lock has been
+# held, which is the time the Scheduler cannot make any decision. If a
+# changer device is provided a cartridge is moved into a drive with mtx
+# before each refresh. LTFS LE reports such a cartridge as not mounted
+# and the refresh has to mount it, which must not happen while the lock
+# is held. The test fails if the lock has been held longer than maxms
+# or if the migration has failed. The number of refreshes, the changer
+# device, a storage slot and a drive number can be provided as arguments.
+
+import sys
+import os
+import re
+import time
+import threading
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test21/"
+filelist = "/dev/shm/test21.list"
+logfile = "/var/run/ltfsdm/LTFSDM.log"
+numfiles = 5000
+size = 1048576
+pool = "pool1"
+iterations = 20
+maxms = 100
+changer = ""
+slot = 0
+drive = 0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles():
+    data = os.urandom(size)
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            name = mandir + testdir + "file." + str(i)
+            with open(name, "wb") as df:
+                df.write(data)
+            f.write(name + "\n")
+
+def migrate(result):
+    result.append(subprocess.call(["ltfsdm", "migrate", "-P", pool, "-f", filelist],
+                                  stdout=open(os.devnull, 'wb')))
+
+def main(argv):
+    global iterations
+    global changer
+    global slot
+    global drive
+
+    if len(argv) > 0:
+        iterations = int(argv[0])
+    if len(argv) > 3:
+        changer = argv[1]
+        slot = int(argv[2])
+        drive = int(argv[3])
+
+    crfiles()
+
+    pattern = re.compile("LTFSDMS0124I.*locked for ([0-9]+) ms")
+    locked = []
+
+    with open(logfile, "a+") as log:
+        log.seek(0, os.SEEK_END)
+
+        result = []
+        migrator = threading.Thread(target=migrate, args=(result,))
+        migrator.start()
+
+        for i in range(iterations):
+            if changer != "":
+                subprocess.call(["mtx", "-f", changer, "load", str(slot), str(drive)],
+                                stdout=open(os.devnull, 'wb'))
+            run(["ltfsdm", "retrieve"])
+            time.sleep(1)
+
+        migrator.join()
+
+        for line in log:
+            res = pattern.search(line)
+            if res != None:
+                locked.append(int(res.group(1)))
+
+    os.remove(filelist)
+
+    if len(locked) == 0:
+        print("no inventory refresh has been logged")
+        sys.exit(-1)
+
+    print(str(len(locked)) + " refreshes, inventory locked for max " + str(max(locked))
+          + " ms, average " + "%.1f" % (float(sum(locked)) / len(locked)) + " ms")
+
+    if result[0] != 0:
+        print("the migration failed")
+        sys.exit(-1)
+
+    if max(locked) > maxms:
+        print("the inventory has been locked longer than " + str(maxms) + " ms")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
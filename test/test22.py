@@ -0,0 +1,122 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Measures per-cartridge lookups in a large catalog. The catalog is
+# filled with the given number of cartridges each holding the given
+# number of files by rebuilding it from generated LTFS indexes (see
+# test4.py). Afterwards the files of each cartridge are listed with
+# "ltfsdm info catalog". Since the catalog is ordered by cartridge and
+# starting block the first entry of a cartridge has to arrive within a
+# second independent of the size of the catalog. The number of
+# cartridges, the number of files per cartridge and the maximum lookup
+# time in seconds can be provided as arguments.
+
+import sys
+import os
+import time
+import subprocess
+
+numtapes = 20
+numfiles = 1000000
+maxsecs = 1.0
+blocks = 4
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def tapeid(t):
+    return "TS%04dL6" % t
+
+def generate(t, index):
+    with open(index, "w") as f:
+        f.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+        f.write('<ltfsindex version="2.4.0">\n')
+        f.write('<directory><name>' + tapeid(t) + '</name><contents>\n')
+        f.write('<directory><name>.ltfsdm</name><contents>\n')
+        for i in range(numfiles):
+            uid = t * numfiles + i
+            f.write('<file><name>ltfsdm.1.2.0.' + str(uid) + '</name>'
+                    '<length>' + str(blocks * 524288) + '</length>'
+                    '<extendedattributes><xattr><key>FILE_PATH</key>'
+                    '<value>/mnt/lxfs/tape' + str(t) + '/dir' + str(i // 1000) + '/file.' + str(i) + '</value>'
+                    '</xattr></extendedattributes>'
+                    '<extentinfo><extent><fileoffset>0</fileoffset><partition>b</partition>'
+                    '<startblock>' + str(3 + i * blocks) + '</startblock>'
+                    '<byteoffset>0</byteoffset><bytecount>' + str(blocks * 524288) + '</bytecount>'
+                    '</extent></extentinfo><fileuid>' + str(uid + 2) + '</fileuid></file>\n')
+        f.write('</contents></directory>\n')
+        f.write('</contents></directory>\n')
+        f.write('</ltfsindex>\n')
+
+def lookup(t):
+    start = time.time()
+    proc = subprocess.Popen(["ltfsdm", "info", "catalog", "-t", tapeid(t)],
+                            stdout=subprocess.PIPE)
+    proc.stdout.readline()
+    first = proc.stdout.readline().split()
+    secs = time.time() - start
+    proc.kill()
+    proc.wait()
+    if len(first) == 0 or first[0].decode() != "3":
+        print("catalog of " + tapeid(t) + " does not start with block 3")
+        sys.exit(-1)
+    return secs
+
+def main(argv):
+    global numtapes
+    global numfiles
+    global maxsecs
+
+    if len(argv) > 0:
+        numtapes = int(argv[0])
+    if len(argv) > 1:
+        numfiles = int(argv[1])
+    if len(argv) > 2:
+        maxsecs = float(argv[2])
+
+    run(["ltfsdm", "stop"])
+    run(["ltfsdm", "start"])
+
+    start = time.time()
+    for t in range(numtapes):
+        index = "/dev/shm/" + tapeid(t) + ".schema"
+        generate(t, index)
+        run(["ltfsdm", "rebuild", "-t", tapeid(t), "-f", index])
+        os.remove(index)
+    print("catalog with " + str(numtapes * numfiles) + " files built: "
+          + "%.3f" % (time.time() - start) + " seconds")
+
+    slowest = 0.0
+    for t in range(numtapes):
+        secs = lookup(t)
+        print("first entry of " + tapeid(t) + ": " + "%.3f" % secs + " seconds")
+        slowest = max(slowest, secs)
+
+    output = subprocess.check_output(["ltfsdm", "info", "catalog", "-t", tapeid(numtapes - 1)])
+    if len(output.splitlines()) != numfiles + 1:
+        print("catalog of " + tapeid(numtapes - 1) + " does not contain " + str(numfiles) + " files")
+        sys.exit(-1)
+
+    if slowest > maxsecs:
+        print("lookup took " + "%.3f" % slowest + " seconds, more than " + str(maxsecs))
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
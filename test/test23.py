@@ -0,0 +1,159 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# End-to-end test of the reconciliation against a populated catalog.
+# Files are migrated, which adds them to the catalog. Afterwards
+# numorphaned of them are deleted and the catalog of the cartridge
+# holding them is rebuilt from an index generated from the catalog
+# itself but without numdangling other files. "ltfsdm reconcile" has to
+# report exactly these files in addition to the mismatches found before.
+# "ltfsdm reconcile -x" has to remove all orphaned entries. Finally the
+# catalog of the cartridge is rebuilt completely, which has to resolve
+# the dangling references again. The mount point of the managed file
+# system and the number of files can be provided as arguments.
+
+import sys
+import os
+import re
+import sqlite3
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test23/"
+filelist = "/dev/shm/test23.list"
+index = "/dev/shm/test23.schema"
+catalog = "/var/lib/ltfsdm/catalog.db"
+numfiles = 100
+numorphaned = 10
+numdangling = 5
+size = 65536
+pool = "pool1"
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def reconcile(args=[]):
+    output = subprocess.check_output(["ltfsdm", "reconcile"] + args).decode()
+    m = re.search(r"(\d+) dangling reference\(s\), (\d+) orphaned tape file\(s\) with (\d+) bytes", output)
+    if m is None:
+        print("no summary from ltfsdm reconcile")
+        sys.exit(-1)
+    return (int(m.group(1)), int(m.group(2)), int(m.group(3)))
+
+def entries(tapeid):
+    db = sqlite3.connect(catalog)
+    rows = db.execute("SELECT START_BLOCK, FS_ID_H, FS_ID_L, I_GEN, I_NUM,"
+                      " FILE_NAME, FILE_SIZE FROM TAPE_FILES WHERE TAPE_ID=?"
+                      " ORDER BY START_BLOCK", (tapeid,)).fetchall()
+    db.close()
+    return rows
+
+def testtape():
+    db = sqlite3.connect(catalog)
+    rows = db.execute("SELECT TAPE_ID, COUNT(*) FROM TAPE_FILES"
+                      " WHERE FILE_NAME LIKE ? GROUP BY TAPE_ID"
+                      " ORDER BY COUNT(*) DESC", ("%/" + testdir + "file.%",)).fetchall()
+    db.close()
+    if len(rows) == 0 or rows[0][1] != numfiles:
+        print("the catalog does not contain the " + str(numfiles) + " migrated files")
+        sys.exit(-1)
+    return rows[0][0]
+
+def rebuild(tapeid, rows):
+    with open(index, "w") as f:
+        f.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+        f.write('<ltfsindex version="2.4.0">\n')
+        f.write('<directory><name>' + tapeid + '</name><contents>\n')
+        f.write('<directory><name>.ltfsdm</name><contents>\n')
+        for (block, fsidh, fsidl, igen, inum, name, length) in rows:
+            f.write('<file><name>ltfsdm.' + str(fsidh % 2**64) + '.' + str(fsidl % 2**64)
+                    + '.' + str(igen) + '.' + str(inum) + '</name>'
+                    '<length>' + str(length) + '</length>'
+                    '<extendedattributes><xattr><key>FILE_PATH</key>'
+                    '<value>' + name + '</value>'
+                    '</xattr></extendedattributes>'
+                    '<extentinfo><extent><fileoffset>0</fileoffset><partition>b</partition>'
+                    '<startblock>' + str(block) + '</startblock>'
+                    '<byteoffset>0</byteoffset><bytecount>' + str(length) + '</bytecount>'
+                    '</extent></extentinfo><fileuid>' + str(inum) + '</fileuid></file>\n')
+        f.write('</contents></directory>\n')
+        f.write('</contents></directory>\n')
+        f.write('</ltfsindex>\n')
+    run(["ltfsdm", "rebuild", "-t", tapeid, "-f", index])
+    os.remove(index)
+
+def check(result, expected, what):
+    if result[0] != expected[0] or result[1] != expected[1] or result[2] != expected[2]:
+        print(what + ": " + str(result) + " instead of " + str(expected)
+              + " (dangling, orphaned, orphaned bytes)")
+        sys.exit(-1)
+
+def main(argv):
+    global mandir
+    global numfiles
+
+    if len(argv) > 0:
+        mandir = argv[0].rstrip("/") + "/"
+    if len(argv) > 1:
+        numfiles = int(argv[1])
+
+    dirname = mandir + testdir
+    if os.path.isdir(dirname) == 0:
+        os.makedirs(dirname)
+    data = os.urandom(size)
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            name = dirname + "file." + str(i)
+            with open(name, "wb") as df:
+                df.write(data)
+            f.write(name + "\n")
+    run(["ltfsdm", "migrate", "-P", pool, "-f", filelist])
+    os.remove(filelist)
+
+    before = reconcile()
+    print("before: " + str(before[0]) + " dangling, " + str(before[1]) + " orphaned")
+
+    tapeid = testtape()
+    rows = entries(tapeid)
+    ours = [r for r in rows if re.search("/" + testdir + r"file\.\d+$", r[5])]
+
+    for r in ours[:numorphaned]:
+        os.remove(dirname + os.path.basename(r[5]))
+    dropped = ours[numorphaned:numorphaned + numdangling]
+    rebuild(tapeid, [r for r in rows if r not in dropped])
+
+    check(reconcile(), (before[0] + numdangling, before[1] + numorphaned,
+                        before[2] + numorphaned * size), "after the changes")
+
+    reconcile(["-x"])
+    check(reconcile(), (before[0] + numdangling, 0, 0), "after the cleanup")
+    if len(entries(tapeid)) != len(rows) - numorphaned - numdangling:
+        print("the orphaned entries have not been removed from the catalog")
+        sys.exit(-1)
+
+    rebuild(tapeid, [r for r in rows if r not in ours[:numorphaned]])
+    check(reconcile(), (before[0], 0, 0), "after the rebuild")
+
+    for r in ours[numorphaned:]:
+        os.remove(dirname + os.path.basename(r[5]))
+    reconcile(["-x"])
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,146 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Checks that a throttled drive is recognized as degraded. It is
+# intended to run against a virtual tape library (mhVTL) with at least
+# two drives. The vtltape daemon serving the first drive listed by
+# "ltfsdm info drives" is throttled by stopping it for stopms out of
+# every periodms milliseconds. Meanwhile files are migrated to two
+# pools in parallel so that all drives write enough data to measure
+# their throughput. Afterwards the throttled drive has to be shown as
+# degraded and all other drives as ok. The two pools and the amount of
+# data per pool in MiB can be provided as arguments.
+
+import sys
+import os
+import re
+import time
+import signal
+import threading
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test24/"
+deviceconf = "/etc/mhvtl/device.conf"
+pools = ["pool1", "pool2"]
+datamb = 4096
+filemb = 256
+periodms = 100
+stopms = 75
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def drives():
+    output = subprocess.check_output(["ltfsdm", "info", "drives"]).decode()
+    return [(l.split()[0], l.split()[-1]) for l in output.splitlines()[1:] if len(l.split()) > 0]
+
+def vtltape(serial):
+    drive = None
+    with open(deviceconf) as f:
+        for line in f:
+            m = re.match(r"Drive:\s+(\d+)", line)
+            if m is not None:
+                drive = m.group(1)
+            elif re.match(r"\s*Unit serial number:\s*" + re.escape(serial) + r"\s*$", line):
+                break
+        else:
+            drive = None
+    if drive is None:
+        print("drive " + serial + " not found in " + deviceconf)
+        sys.exit(-1)
+    pids = subprocess.check_output(["pgrep", "-f", r"vtltape .*-q ?" + drive + r"( |$)"]).split()
+    return int(pids[0])
+
+def throttle(pid, done):
+    while not done.is_set():
+        os.kill(pid, signal.SIGSTOP)
+        time.sleep(stopms / 1000.0)
+        os.kill(pid, signal.SIGCONT)
+        time.sleep((periodms - stopms) / 1000.0)
+
+def crfiles(pool):
+    dirname = mandir + testdir + pool + "/"
+    filelist = "/dev/shm/test24." + pool + ".list"
+    if os.path.isdir(dirname) == 0:
+        os.makedirs(dirname)
+    data = os.urandom(1048576)
+    with open(filelist, "w") as f:
+        for i in range(datamb // filemb):
+            name = dirname + "file." + str(i)
+            with open(name, "wb") as df:
+                for j in range(filemb):
+                    df.write(data)
+            f.write(name + "\n")
+    return filelist
+
+def main(argv):
+    global pools
+    global datamb
+
+    if len(argv) > 1:
+        pools = argv[0:2]
+    if len(argv) > 2:
+        datamb = int(argv[2])
+
+    before = drives()
+    if len(before) < 2:
+        print("at least two drives are required")
+        sys.exit(-1)
+    slow = before[0][0]
+    pid = vtltape(slow)
+
+    filelists = [crfiles(pool) for pool in pools]
+
+    done = threading.Event()
+    thrd = threading.Thread(target=throttle, args=(pid, done))
+    thrd.start()
+
+    try:
+        start = time.time()
+        procs = [subprocess.Popen(["ltfsdm", "migrate", "-P", pools[i], "-f", filelists[i]],
+                                  stdout=open(os.devnull, 'wb')) for i in range(len(pools))]
+        rcs = [proc.wait() for proc in procs]
+        secs = time.time() - start
+    finally:
+        done.set()
+        thrd.join()
+        os.kill(pid, signal.SIGCONT)
+
+    for filelist in filelists:
+        os.remove(filelist)
+
+    if rcs != [0] * len(pools):
+        print("migration failed")
+        sys.exit(-1)
+
+    print("migration of " + str(datamb * len(pools)) + " MiB: " + "%.3f" % secs + " seconds")
+
+    for (drive, health) in drives():
+        print("drive " + drive + ": " + health)
+        if drive == slow and health != "degraded":
+            print("throttled drive " + drive + " is not degraded")
+            sys.exit(-1)
+        if drive != slow and health == "degraded":
+            print("drive " + drive + " is degraded but has not been throttled")
+            sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
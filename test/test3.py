@@ -0,0 +1,116 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Measures how long it takes until each managed file system is ready
+# after the backend has been started. Each file system is a loop mounted
+# ext4 image on /dev/shm, so the file system data is held in tmpfs and
+# the measurement does not depend on a disk. Plain tmpfs mounts cannot
+# be used since they do not provide a UUID and more than one of them
+# cannot be added. The log file is followed while the backend starts and
+# the time at which LTFSDMS0119I is logged is recorded for each file
+# system. The test fails if a file system does not become ready or takes
+# longer than maxsecs. The number of file systems can be provided as an
+# argument.
+
+import sys
+import os
+import re
+import time
+import subprocess
+
+numfss = 16
+imgsize = 64
+imgdir = "/dev/shm/"
+mntdir = "/mnt/startup"
+logfile = "/var/run/ltfsdm/LTFSDM.log"
+iterations = 5
+maxsecs = 5.0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def prepare():
+    os.system("ltfsdm stop")
+
+    for i in range(numfss):
+        image = imgdir + "startup" + str(i) + ".img"
+        mountpt = mntdir + str(i)
+        if os.path.ismount(mountpt):
+            continue
+        if os.path.isfile(image) == 0:
+            run(["dd", "if=/dev/zero", "of=" + image, "bs=1M", "count=" + str(imgsize)])
+            run(["mkfs.ext4", "-q", "-F", image])
+        if os.path.isdir(mountpt) == 0:
+            os.mkdir(mountpt)
+        run(["mount", "-o", "loop", image, mountpt])
+
+    run(["ltfsdm", "start"])
+
+    for i in range(numfss):
+        run(["ltfsdm", "add", mntdir + str(i)])
+
+def startup():
+    ready = {}
+    fss = set(mntdir + str(i) for i in range(numfss))
+    pattern = re.compile("LTFSDMS0119I.*'(.*)'")
+
+    with open(logfile, "a+") as log:
+        log.seek(0, os.SEEK_END)
+        start = time.time()
+        proc = subprocess.Popen(["ltfsdm", "start"], stdout=open(os.devnull, 'wb'))
+        while len(ready) < numfss and time.time() - start < 2 * maxsecs:
+            line = log.readline()
+            if not line:
+                time.sleep(0.01)
+                continue
+            res = pattern.search(line)
+            if res != None and res.group(1) in fss:
+                ready[res.group(1)] = time.time() - start
+        if proc.wait() != 0:
+            print("command failed: ltfsdm start")
+            sys.exit(-1)
+
+    return ready
+
+def main(argv):
+    global numfss
+
+    if len(argv) > 0:
+        numfss = int(argv[0])
+
+    prepare()
+
+    for i in range(iterations):
+        run(["ltfsdm", "stop"])
+        ready = startup()
+        for j in range(numfss):
+            mountpt = mntdir + str(j)
+            if mountpt not in ready:
+                print(mountpt + " did not become ready")
+                sys.exit(-1)
+            print(mountpt + " ready after " + "%.3f" % ready[mountpt] + " seconds")
+            if ready[mountpt] > maxsecs:
+                print(mountpt + " took longer than " + str(maxsecs) + " seconds")
+                sys.exit(-1)
+        print("start with " + str(numfss) + " file systems: all ready after "
+              + "%.3f" % max(ready.values()) + " seconds")
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,96 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Measures the time and the memory the backend needs to rebuild the
+# catalog of a cartridge from an LTFS index. The index is generated with
+# the given number of files stored by the backend. The number of files
+# can be provided as an argument.
+
+import sys
+import os
+import time
+import subprocess
+
+numfiles = 1000000
+tapeid = "TEST00L6"
+index = "/dev/shm/" + tapeid + ".schema"
+blocks = 4
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        exit(-1)
+
+def generate():
+    with open(index, "w") as f:
+        f.write('<?xml version="1.0" encoding="UTF-8"?>\n')
+        f.write('<ltfsindex version="2.4.0">\n')
+        f.write('<directory><name>' + tapeid + '</name><contents>\n')
+        f.write('<directory><name>.ltfsdm</name><contents>\n')
+        for i in range(numfiles):
+            f.write('<file><name>ltfsdm.1.2.0.' + str(i) + '</name>'
+                    '<length>' + str(blocks * 524288) + '</length>'
+                    '<extendedattributes><xattr><key>FILE_PATH</key>'
+                    '<value>/mnt/lxfs/dir' + str(i // 1000) + '/file.' + str(i) + '</value>'
+                    '</xattr></extendedattributes>'
+                    '<extentinfo><extent><fileoffset>0</fileoffset><partition>b</partition>'
+                    '<startblock>' + str(3 + i * blocks) + '</startblock>'
+                    '<byteoffset>0</byteoffset><bytecount>' + str(blocks * 524288) + '</bytecount>'
+                    '</extent></extentinfo><fileuid>' + str(i + 2) + '</fileuid></file>\n')
+        f.write('</contents></directory>\n')
+        f.write('</contents></directory>\n')
+        f.write('</ltfsindex>\n')
+
+def peakmem():
+    pid = subprocess.check_output(["pidof", "ltfsdmd"]).split()[0].decode()
+    with open("/proc/" + pid + "/status") as f:
+        for line in f:
+            if line.startswith("VmHWM:"):
+                return line.split()[1] + " kB"
+    return "unknown"
+
+def main(argv):
+    global numfiles
+
+    if len(argv) > 0:
+        numfiles = int(argv[0])
+
+    generate()
+    print("index with " + str(numfiles) + " files: " + str(os.path.getsize(index)) + " bytes")
+
+    run(["ltfsdm", "stop"])
+    run(["ltfsdm", "start"])
+
+    print("peak memory of the backend before: " + peakmem())
+
+    start = time.time()
+    run(["ltfsdm", "rebuild", "-t", tapeid, "-f", index])
+    secs = time.time() - start
+
+    print("rebuild of " + str(numfiles) + " files: " + "%.3f" % secs + " seconds")
+    print("peak memory of the backend after: " + peakmem())
+
+    output = subprocess.check_output(["ltfsdm", "info", "catalog", "-t", tapeid])
+    if len(output.splitlines()) != numfiles + 1:
+        print("catalog of " + tapeid + " does not contain " + str(numfiles) + " files")
+        exit(-1)
+
+    os.remove(index)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,116 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the premigration throughput of large files from a source file
+# system that is slower than a single reader. The managed file system is
+# an ext4 file system on a dm-delay device that delays each read by
+# delay milliseconds. A single sequential reader is limited by that
+# latency while several readers keep several requests in flight. Files
+# of at least Const::PARALLEL_READ_MIN_SIZE are read by several threads
+# (see ChunkReader). The throughput of a single reader is measured with
+# dd first. The test fails if the premigration is not at least
+# minspeedup times faster. The delay in milliseconds can be provided as
+# an argument.
+
+import sys
+import os
+import time
+import subprocess
+
+image = "/var/tmp/chunkreader.img"
+imgsize = 8192
+dmname = "chunkreader"
+mountpt = "/mnt/chunkreader"
+numfiles = 4
+filesize = 1024
+pool = "pool1"
+delay = 10
+minspeedup = 1.5
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def prepare():
+    if os.path.ismount(mountpt) == 0:
+        if os.path.isfile(image) == 0:
+            run(["dd", "if=/dev/zero", "of=" + image, "bs=1M", "count=" + str(imgsize)])
+            run(["mkfs.ext4", "-q", "-F", image])
+        loopdev = subprocess.check_output(["losetup", "-f", "--show", image]).decode().strip()
+        sectors = imgsize * 2048
+        run(["dmsetup", "create", dmname, "--table",
+             "0 " + str(sectors) + " delay " + loopdev + " 0 " + str(delay)])
+        if os.path.isdir(mountpt) == 0:
+            os.mkdir(mountpt)
+        run(["mount", "/dev/mapper/" + dmname, mountpt])
+
+    for i in range(numfiles):
+        name = mountpt + "/file." + str(i)
+        if os.path.isfile(name) == 0:
+            run(["dd", "if=/dev/urandom", "of=" + name, "bs=1M", "count=" + str(filesize)])
+
+    name = mountpt + "/single"
+    if os.path.isfile(name) == 0:
+        run(["dd", "if=/dev/urandom", "of=" + name, "bs=1M", "count=" + str(filesize)])
+
+    run(["ltfsdm", "stop"])
+    run(["ltfsdm", "start"])
+    run(["ltfsdm", "add", mountpt])
+
+def dropcaches():
+    run(["sync"])
+    with open("/proc/sys/vm/drop_caches", "w") as f:
+        f.write("3\n")
+
+def single():
+    dropcaches()
+    start = time.time()
+    run(["dd", "if=" + mountpt + "/single", "of=/dev/null", "bs=512K"])
+    return filesize / (time.time() - start)
+
+def main(argv):
+    global delay
+
+    if len(argv) > 0:
+        delay = int(argv[0])
+
+    prepare()
+
+    baseline = single()
+
+    dropcaches()
+
+    files = [mountpt + "/file." + str(i) for i in range(numfiles)]
+
+    start = time.time()
+    run(["ltfsdm", "migrate", "-p", "-P", pool] + files)
+    secs = time.time() - start
+
+    mbytes = numfiles * filesize
+    print("single reader with a delay of " + str(delay) + " ms: " + "%.1f" % baseline + " MB/s")
+    print("premigration of " + str(mbytes) + " MB: " + "%.3f" % secs + " seconds, "
+          + "%.1f" % (mbytes / secs) + " MB/s")
+
+    if mbytes / secs < minspeedup * baseline:
+        print("the premigration was not " + str(minspeedup) + " times faster than a single reader")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,95 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the cost of the thread pool statistics. Many small files are
+# migrated with one request such that the stubbing pool processes many
+# short tasks. The elapsed time and the task rate are printed together
+# with the output of "ltfsdm info threads". The completed counter of the
+# stubbing pool has to grow by the number of batches processed. Run it
+# with a build without the statistics to compare. The number of files
+# can be provided as an argument.
+
+import sys
+import os
+import time
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test6/"
+numfiles = 100000
+size = 4096
+pool = "pool1"
+stubbingpool = "stub1-wq"
+batchsize = 32
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        exit(-1)
+
+def completed(name):
+    output = subprocess.check_output(["ltfsdm", "info", "threads"]).decode()
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 6 and fields[0] == name:
+            return int(fields[5])
+    print("thread pool " + name + " not found")
+    exit(-1)
+
+def crfiles():
+    data = os.urandom(size)
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    with open("/dev/shm/test6.list", "w") as filelist:
+        for i in range(numfiles):
+            name = mandir + testdir + "file." + str(i)
+            with open(name, "wb") as f:
+                f.write(data)
+            filelist.write(name + "\n")
+
+def main(argv):
+    global numfiles
+
+    if len(argv) > 0:
+        numfiles = int(argv[0])
+
+    crfiles()
+
+    before = completed(stubbingpool)
+
+    start = time.time()
+    run(["ltfsdm", "migrate", "-P", pool, "-f", "/dev/shm/test6.list"])
+    secs = time.time() - start
+
+    after = completed(stubbingpool)
+
+    print("migration of " + str(numfiles) + " files: " + "%.3f" % secs + " seconds")
+    print(str(after - before) + " stubbing tasks: "
+          + "%.1f" % ((after - before) / secs) + " tasks/s")
+
+    subprocess.call(["ltfsdm", "info", "threads"])
+
+    if after - before < (numfiles + batchsize - 1) // batchsize:
+        print("the stubbing pool completed less tasks than expected")
+        exit(-1)
+
+    os.remove("/dev/shm/test6.list")
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
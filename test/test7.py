@@ -0,0 +1,129 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures the startup time of the backend and the time of "ltfsdm info
+# fs" with a large mount table. The mount table is enlarged by bind
+# mounts of a directory on /dev/shm that are not managed. The file
+# systems managed before are kept. The mount table only needs to be
+# parsed again if it changed, so the times should grow only slightly
+# with the number of bind mounts. The times are measured without the
+# bind mounts first. The test fails if a time with the bind mounts
+# exceeds maxratio times that baseline plus slack seconds or if "ltfsdm
+# info fs" does not show the same file systems anymore. The number of
+# bind mounts can be provided as an argument.
+
+import sys
+import os
+import time
+import subprocess
+
+numbinds = 10000
+binddir = "/dev/shm/mountinfo"
+bindsrc = "/dev/shm/mountinfo.src"
+iterations = 5
+maxratio = 2.0
+slack = 0.5
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def mountinfo_size():
+    with open("/proc/self/mountinfo") as f:
+        return len(f.readlines())
+
+def bind():
+    for d in [binddir, bindsrc]:
+        if os.path.isdir(d) == 0:
+            os.mkdir(d)
+    # avoid that the bind mounts propagate to other mount points
+    if os.path.ismount(binddir) == 0:
+        run(["mount", "--bind", binddir, binddir])
+        run(["mount", "--make-private", binddir])
+    for i in range(numbinds):
+        target = binddir + "/" + str(i)
+        if os.path.isdir(target) == 0:
+            os.mkdir(target)
+        if os.path.ismount(target) == 0:
+            run(["mount", "--bind", bindsrc, target])
+
+def unbind():
+    for i in reversed(range(numbinds)):
+        target = binddir + "/" + str(i)
+        if os.path.ismount(target):
+            run(["umount", target])
+    if os.path.ismount(binddir):
+        run(["umount", binddir])
+
+def measure(args):
+    start = time.time()
+    run(args)
+    return time.time() - start
+
+def infofs():
+    return subprocess.check_output(["ltfsdm", "info", "fs"]).decode()
+
+def series(name):
+    starts = []
+    infos = []
+    for i in range(iterations):
+        starts.append(measure(["ltfsdm", "start"]))
+        infos.append(measure(["ltfsdm", "info", "fs"]))
+        output = infofs()
+        run(["ltfsdm", "stop"])
+    print(name + ": start " + "%.3f" % max(starts) + " seconds, info fs "
+          + "%.3f" % max(infos) + " seconds (max of " + str(iterations) + ")")
+    return (max(starts), max(infos), output)
+
+def check(name, secs, base):
+    if secs > maxratio * base + slack:
+        print(name + " took " + "%.3f" % secs + " seconds, without bind mounts "
+              + "%.3f" % base + " seconds")
+        sys.exit(-1)
+
+def main(argv):
+    global numbinds
+
+    if len(argv) > 0:
+        numbinds = int(argv[0])
+
+    run(["ltfsdm", "stop"])
+    print("mount table with " + str(mountinfo_size()) + " entries")
+    base = series("without bind mounts")
+
+    bind()
+    print("mount table with " + str(mountinfo_size()) + " entries")
+
+    try:
+        large = series("with " + str(numbinds) + " bind mounts")
+    finally:
+        unbind()
+
+    run(["ltfsdm", "start"])
+
+    check("start", large[0], base[0])
+    check("info fs", large[1], base[1])
+
+    if large[2] != base[2]:
+        print("info fs shows different file systems with the bind mounts")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,105 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Checks that the writes of the backend to tape are aligned to the block
+# size of the LTFS file system. Files with sizes that are not a multiple
+# of the block size are premigrated while the write system calls of the
+# backend are traced by strace. Except for the last write of each file
+# all writes to the LTFS mount point need to be a multiple of the block
+# size. The number of writes and their sizes are printed. The LTFS
+# mount point can be provided as an argument.
+
+import sys
+import os
+import re
+import time
+import subprocess
+
+ltfsdir = "/ltfs"
+mandir = "/mnt/lxfs/"
+testdir = "test8/"
+sizes = [1, 524287, 524289, 3 * 1048576 + 17, 300 * 1048576 + 4097]
+pool = "pool1"
+trace = "/dev/shm/test8.strace"
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crfiles():
+    files = []
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    for size in sizes:
+        name = mandir + testdir + "file." + str(size)
+        with open(name, "wb") as f:
+            f.write(os.urandom(size))
+        files.append(name)
+    return files
+
+def main(argv):
+    global ltfsdir
+
+    if len(argv) > 0:
+        ltfsdir = argv[0]
+
+    blocksize = os.statvfs(ltfsdir).f_bsize
+    print("LTFS block size: " + str(blocksize))
+
+    files = crfiles()
+
+    pid = subprocess.check_output(["pidof", "ltfsdmd"]).split()[0].decode()
+    strace = subprocess.Popen(["strace", "-f", "-y", "-e", "trace=write",
+                               "-e", "signal=none", "-o", trace, "-p", pid],
+                              stderr=open(os.devnull, 'wb'))
+    time.sleep(1)
+
+    run(["ltfsdm", "migrate", "-p", "-P", pool] + files)
+
+    strace.terminate()
+    strace.wait()
+
+    writes = {}
+    pattern = re.compile(r'write\(\d+<(' + re.escape(ltfsdir) + r'[^>]*)>, .*\) = (\d+)$')
+    with open(trace) as f:
+        for line in f:
+            match = pattern.search(line.strip())
+            if match:
+                writes.setdefault(match.group(1), []).append(int(match.group(2)))
+
+    unaligned = 0
+    total = 0
+    for name, sizelist in writes.items():
+        total += len(sizelist)
+        for size in sizelist[:-1]:
+            if size % blocksize != 0:
+                unaligned += 1
+        print(name + ": " + str(len(sizelist)) + " writes, sizes "
+              + ", ".join(sorted(set(str(s) for s in sizelist))))
+
+    os.remove(trace)
+
+    print(str(total) + " writes to tape, " + str(unaligned) + " unaligned")
+    if len(writes) != len(sizes) or unaligned > 0:
+        print("the writes to tape are not aligned to the block size")
+        sys.exit(-1)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
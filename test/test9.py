@@ -0,0 +1,105 @@
+#!/usr/bin/python
+
+# Copyright 2017 IBM Corp. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#  https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Measures how fast the client resolves the file names of a large file
+# list. A synthetic directory tree is created in a managed file system
+# and is listed through a symbolic link and with ".." components, so
+# that each name needs to be canonicalized (see FileNameResolver). The
+# files are resident and are recalled, which makes the backend skip
+# them quickly. The dentry cache is dropped before each run to show the
+# effect of resolving names in parallel on cold metadata. The backend
+# logs LTFSDMS0026I for each resident file it receives. The test fails
+# if this message has not been logged for every file of the list, i.e.
+# if names got lost or could not be resolved, or if less than minrate
+# names have been processed per second. The number of files can be
+# provided as an argument.
+
+import sys
+import os
+import time
+import subprocess
+
+mandir = "/mnt/lxfs/"
+testdir = "test9/"
+link = "/dev/shm/test9.link"
+filelist = "/dev/shm/test9.list"
+numfiles = 1000000
+perdir = 1000
+iterations = 3
+logfile = "/var/run/ltfsdm/LTFSDM.log"
+minrate = 20000.0
+
+def run(args):
+    if subprocess.call(args, stdout=open(os.devnull, 'wb')) != 0:
+        print("command failed: " + " ".join(args))
+        sys.exit(-1)
+
+def crtree():
+    if os.path.isdir(mandir + testdir) == 0:
+        os.mkdir(mandir + testdir)
+    for i in range(numfiles):
+        dirname = mandir + testdir + "dir." + str(i // perdir)
+        if i % perdir == 0 and os.path.isdir(dirname) == 0:
+            os.mkdir(dirname)
+        name = dirname + "/file." + str(i)
+        if os.path.isfile(name) == 0:
+            open(name, "w").close()
+    if os.path.islink(link) == 0:
+        os.symlink(mandir + testdir, link)
+
+def crlist():
+    with open(filelist, "w") as f:
+        for i in range(numfiles):
+            d = "dir." + str(i // perdir)
+            f.write(link + "/" + d + "/../" + d + "/file." + str(i) + "\n")
+
+def main(argv):
+    global numfiles
+
+    if len(argv) > 0:
+        numfiles = int(argv[0])
+
+    crtree()
+    crlist()
+
+    for i in range(iterations):
+        run(["sync"])
+        with open("/proc/sys/vm/drop_caches", "w") as f:
+            f.write("2\n")
+        with open(logfile) as log:
+            log.seek(0, os.SEEK_END)
+            start = time.time()
+            run(["ltfsdm", "recall", "-f", filelist])
+            secs = time.time() - start
+            received = sum(1 for line in log if "LTFSDMS0026I" in line)
+        print("list of " + str(numfiles) + " names: " + "%.3f" % secs
+              + " seconds, " + "%.0f" % (numfiles / secs) + " names/s, "
+              + str(received) + " names received by the backend")
+        if received != numfiles:
+            print("not all names have been resolved and sent to the backend")
+            sys.exit(-1)
+        if numfiles / secs < minrate:
+            print("less than " + str(minrate) + " names/s")
+            sys.exit(-1)
+
+    os.remove(filelist)
+    os.remove(link)
+
+    print("== test finished ==")
+
+if __name__ == "__main__":
+    main(sys.argv[1:])